@@ -0,0 +1,44 @@
+//
+// propertiesfatfsfile.h
+//
+// Host replacement of the Circle properties in a FatFs file: "name=value"
+// lines, comments start with '#'.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fatfs/ff.h>
+
+class CPropertiesFatFsFile
+{
+public:
+	CPropertiesFatFsFile(const char *pFileName, FATFS *pFileSystem);
+
+	bool Load();
+	bool Save();
+
+	void RemoveAll();
+
+	bool IsSet(const char *pPropertyName) const;
+
+	const char *GetString(const char *pPropertyName, const char *pDefault = nullptr) const;
+	unsigned GetNumber(const char *pPropertyName, unsigned nDefault = 0) const;
+	int GetSignedNumber(const char *pPropertyName, int nDefault = 0) const;
+	const uint8_t *GetIPAddress(const char *pPropertyName) const;
+
+	void SetString(const char *pPropertyName, const char *pValue);
+	void SetNumber(const char *pPropertyName, unsigned nValue, unsigned nBase = 10);
+	void SetSignedNumber(const char *pPropertyName, int nValue);
+
+private:
+	const std::string *Find(const char *pPropertyName) const;
+
+	std::string m_FileName;
+	std::vector<std::pair<std::string, std::string>> m_Properties; // in the order of the file
+
+	mutable uint8_t m_IPAddress[4];
+};
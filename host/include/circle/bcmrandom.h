@@ -0,0 +1,15 @@
+//
+// bcmrandom.h
+//
+// Host replacement of the Circle random number generator
+//
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+class CBcmRandomNumberGenerator
+{
+public:
+	uint32_t GetNumber() { return static_cast<uint32_t>(rand()); }
+};
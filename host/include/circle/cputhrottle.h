@@ -0,0 +1,35 @@
+//
+// cputhrottle.h
+//
+// Host replacement of the Circle CPU throttle
+//
+#pragma once
+
+enum TCPUSpeed
+{
+	CPUSpeedLow,
+	CPUSpeedMaximum,
+	CPUSpeedUnknown
+};
+
+class CCPUThrottle
+{
+public:
+	static CCPUThrottle *Get()
+	{
+		static CCPUThrottle s_CPUThrottle;
+		return &s_CPUThrottle;
+	}
+
+	bool IsDynamic() const { return false; }
+	unsigned GetClockRate() const { return 0; }
+	unsigned GetMinClockRate() const { return 0; }
+	unsigned GetMaxClockRate() const { return 0; }
+	unsigned GetTemperature() const { return 0; }
+	unsigned GetMaxTemperature() const { return 0; }
+
+	TCPUSpeed SetSpeed(TCPUSpeed Speed, bool bWait = true) { return CPUSpeedMaximum; }
+	bool SetOnTemperature() { return true; }
+	bool Update() { return true; }
+	void DumpStatus(bool bAll = true) {}
+};
@@ -0,0 +1,17 @@
+//
+// device.h
+//
+// Host replacement of the Circle device base class
+//
+#pragma once
+
+#include <cstddef>
+
+class CDevice
+{
+public:
+	virtual ~CDevice() {}
+
+	virtual int Read(void *pBuffer, size_t nCount) { return -1; }
+	virtual int Write(const void *pBuffer, size_t nCount) { return -1; }
+};
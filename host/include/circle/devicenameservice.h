@@ -0,0 +1,21 @@
+//
+// devicenameservice.h
+//
+// Host replacement of the Circle device name service, which knows no device
+//
+#pragma once
+
+#include <circle/device.h>
+
+class CDeviceNameService
+{
+public:
+	static CDeviceNameService *Get()
+	{
+		static CDeviceNameService s_DeviceNameService;
+		return &s_DeviceNameService;
+	}
+
+	CDevice *GetDevice(const char *pName, bool bBlockDevice) { return nullptr; }
+	CDevice *GetDevice(const char *pPrefix, unsigned nIndex, bool bBlockDevice) { return nullptr; }
+};
@@ -0,0 +1,18 @@
+//
+// font.h
+//
+// Host replacement of the Circle font
+//
+#pragma once
+
+#include <circle/types.h>
+
+struct TFont
+{
+	unsigned width;
+	unsigned height;
+	unsigned extraheight;
+	u8 first_char;
+	u8 last_char;
+	const void *data; // u8 or u16 per line
+};
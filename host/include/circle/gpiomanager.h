@@ -0,0 +1,16 @@
+//
+// gpiomanager.h
+//
+// Host replacement of the Circle GPIO manager
+//
+#pragma once
+
+#include <circle/interrupt.h>
+
+class CGPIOManager
+{
+public:
+	CGPIOManager(CInterruptSystem *pInterrupt) {}
+
+	bool Initialize() { return true; }
+};
@@ -0,0 +1,46 @@
+//
+// gpiopin.h
+//
+// Host replacement of the Circle GPIO pin, whose input is always high
+//
+#pragma once
+
+#include <circle/gpiomanager.h>
+
+#define LOW 0
+#define HIGH 1
+
+enum TGPIOMode
+{
+	GPIOModeInput,
+	GPIOModeOutput,
+	GPIOModeInputPullUp,
+	GPIOModeInputPullDown,
+	GPIOModeUnknown
+};
+
+enum TGPIOInterrupt
+{
+	GPIOInterruptOnRisingEdge,
+	GPIOInterruptOnFallingEdge,
+	GPIOInterruptOnBothEdges,
+	GPIOInterruptOnHighLevel,
+	GPIOInterruptOnLowLevel,
+	GPIOInterruptOnAsyncRisingEdge,
+	GPIOInterruptOnAsyncFallingEdge,
+	GPIOInterruptUnknown
+};
+
+class CGPIOPin
+{
+public:
+	CGPIOPin() {}
+	CGPIOPin(unsigned nPin, TGPIOMode Mode, CGPIOManager *pManager = nullptr) {}
+
+	void AssignPin(unsigned nPin) {}
+	void SetMode(TGPIOMode Mode, bool bInitPin = true) {}
+	void SetPullMode(int PullMode) {}
+
+	unsigned Read() const { return HIGH; }
+	void Write(unsigned nValue) {}
+};
@@ -0,0 +1,20 @@
+//
+// i2cmaster.h
+//
+// Host replacement of the Circle I2C master, which has no devices
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class CI2CMaster
+{
+public:
+	CI2CMaster(unsigned nDevice, bool bFastMode = false, unsigned nConfig = 0) {}
+
+	bool Initialize() { return true; }
+
+	int Read(uint8_t ucAddress, void *pBuffer, unsigned nCount) { return -1; }
+	int Write(uint8_t ucAddress, const void *pBuffer, unsigned nCount) { return -1; }
+};
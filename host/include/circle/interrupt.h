@@ -0,0 +1,10 @@
+//
+// interrupt.h
+//
+// Host replacement of the Circle interrupt system
+//
+#pragma once
+
+class CInterruptSystem
+{
+};
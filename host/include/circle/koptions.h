@@ -0,0 +1,18 @@
+//
+// koptions.h
+//
+// Host replacement of the Circle kernel options
+//
+#pragma once
+
+class CKernelOptions
+{
+public:
+	static CKernelOptions *Get()
+	{
+		static CKernelOptions s_KernelOptions;
+		return &s_KernelOptions;
+	}
+
+	unsigned GetSoCMaxTemp() const { return 60; }
+};
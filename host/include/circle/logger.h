@@ -0,0 +1,30 @@
+//
+// logger.h
+//
+// Host replacement of the Circle logger, which writes to stderr. A message
+// is written at once, as the cores log concurrently.
+//
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+
+inline void HostLog(const char *pSource, const char *pSeverity, const char *pMessage, ...)
+{
+	char Buffer[512];
+	int nLen = snprintf(Buffer, sizeof Buffer - 1, "%s: %s", pSource, pSeverity);
+
+	va_list var;
+	va_start(var, pMessage);
+	vsnprintf(Buffer + nLen, sizeof Buffer - 1 - nLen, pMessage, var);
+	va_end(var);
+
+	fprintf(stderr, "%s\n", Buffer);
+}
+
+#define LOGMODULE(name) static const char From[] = name
+#define LOGPANIC(...) HostLog(From, "panic: ", __VA_ARGS__)
+#define LOGERR(...) HostLog(From, "error: ", __VA_ARGS__)
+#define LOGWARN(...) HostLog(From, "warning: ", __VA_ARGS__)
+#define LOGNOTE(...) HostLog(From, "", __VA_ARGS__)
+#define LOGDBG(...) ((void)0)
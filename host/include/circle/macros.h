@@ -0,0 +1,8 @@
+//
+// macros.h
+//
+// Host replacement of the Circle macros.
+//
+#pragma once
+
+#define PACKED __attribute__((packed))
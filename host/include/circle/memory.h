@@ -0,0 +1,12 @@
+//
+// memory.h
+//
+// Host replacement of the Circle memory system.
+//
+#pragma once
+
+class CMemorySystem
+{
+public:
+	static CMemorySystem *Get();
+};
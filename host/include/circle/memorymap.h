@@ -0,0 +1,8 @@
+//
+// memorymap.h
+//
+// Host replacement of the Circle memory map
+//
+#pragma once
+
+#define MEGABYTE 0x100000
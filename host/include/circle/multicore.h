@@ -0,0 +1,33 @@
+//
+// multicore.h
+//
+// Host replacement of the Circle multi core support: cores 1 to 3 are
+// threads, which Initialize() starts. An IPI wakes up the waiting cores.
+//
+#pragma once
+
+#include <circle/memory.h>
+#include <circle/synchronize.h>
+#include <circle/sysconfig.h>
+
+#define IPI_USER 10
+
+class CMultiCoreSupport
+{
+public:
+	CMultiCoreSupport(CMemorySystem *pMemorySystem);
+	virtual ~CMultiCoreSupport();
+
+	bool Initialize();
+
+	virtual void Run(unsigned nCore) = 0;
+
+	virtual void IPIHandler(unsigned nCore, unsigned nIPI) {}
+
+	void SendIPI(unsigned nCore, unsigned nIPI);
+
+	static unsigned ThisCore();
+
+	// host only, the cores in WaitForEvent() now
+	static unsigned GetWaitingCores();
+};
@@ -0,0 +1,13 @@
+//
+// net/in.h
+//
+// Host replacement of the Circle network definitions
+//
+#pragma once
+
+#define IPPROTO_TCP 6
+#define IPPROTO_UDP 17
+
+#define MSG_DONTWAIT 0x40
+
+#define FRAME_BUFFER_SIZE 1600
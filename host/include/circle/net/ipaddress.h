@@ -0,0 +1,56 @@
+//
+// net/ipaddress.h
+//
+// Host replacement of the Circle IP address
+//
+#pragma once
+
+#include <circle/string.h>
+#include <circle/types.h>
+
+#include <cstring>
+
+#define IP_ADDRESS_SIZE 4
+
+class CIPAddress
+{
+public:
+	CIPAddress() : m_Address{} {}
+	CIPAddress(u32 nAddress) { Set(nAddress); }
+	CIPAddress(const u8 *pAddress) { Set(pAddress); }
+
+	bool operator==(const CIPAddress &rAddress2) const { return memcmp(m_Address, rAddress2.m_Address, IP_ADDRESS_SIZE) == 0; }
+	bool operator!=(const CIPAddress &rAddress2) const { return !operator==(rAddress2); }
+	bool operator==(const u8 *pAddress2) const { return memcmp(m_Address, pAddress2, IP_ADDRESS_SIZE) == 0; }
+	bool operator!=(const u8 *pAddress2) const { return !operator==(pAddress2); }
+	bool operator==(u32 nAddress2) const { return *this == CIPAddress(nAddress2); }
+	bool operator!=(u32 nAddress2) const { return !operator==(nAddress2); }
+
+	operator u32() const
+	{
+		u32 nAddress;
+		memcpy(&nAddress, m_Address, IP_ADDRESS_SIZE);
+		return nAddress;
+	}
+
+	void Set(u32 nAddress) { memcpy(m_Address, &nAddress, IP_ADDRESS_SIZE); }
+	void Set(const u8 *pAddress) { memcpy(m_Address, pAddress, IP_ADDRESS_SIZE); }
+	void Set(const CIPAddress &rAddress) { Set(rAddress.m_Address); }
+	void SetBroadcast() { memset(m_Address, 0xFF, IP_ADDRESS_SIZE); }
+
+	const u8 *Get() const { return m_Address; }
+	void CopyTo(u8 *pBuffer) const { memcpy(pBuffer, m_Address, IP_ADDRESS_SIZE); }
+
+	bool IsSet() const { return !IsNull(); }
+	bool IsNull() const { return *this == 0U; }
+	bool IsBroadcast() const { return *this == 0xFFFFFFFFU; }
+	unsigned GetSize() const { return IP_ADDRESS_SIZE; }
+
+	void Format(CString *pString) const
+	{
+		pString->Format("%u.%u.%u.%u", m_Address[0], m_Address[1], m_Address[2], m_Address[3]);
+	}
+
+private:
+	u8 m_Address[IP_ADDRESS_SIZE];
+};
@@ -0,0 +1,46 @@
+//
+// net/netsubsystem.h
+//
+// Host replacement of the Circle network subsystem, which does not start
+//
+#pragma once
+
+#include <circle/net/ipaddress.h>
+#include <circle/netdevice.h>
+#include <circle/types.h>
+
+class CNetConfig
+{
+public:
+	const CIPAddress *GetIPAddress() const { return &m_IPAddress; }
+	const CIPAddress *GetNetMask() const { return &m_IPAddress; }
+	const CIPAddress *GetDefaultGateway() const { return &m_IPAddress; }
+	const CIPAddress *GetDNSServer() const { return &m_IPAddress; }
+	const CIPAddress *GetBroadcastAddress() const { return &m_IPAddress; }
+
+private:
+	CIPAddress m_IPAddress;
+};
+
+class CNetSubSystem
+{
+public:
+	CNetSubSystem(const u8 *pIPAddress = nullptr, const u8 *pNetMask = nullptr, const u8 *pDefaultGateway = nullptr,
+		      const u8 *pDNSServer = nullptr, const char *pHostname = "raspberrypi",
+		      TNetDeviceType DeviceType = NetDeviceTypeEthernet) :
+	m_pHostname{pHostname}
+	{
+	}
+
+	bool Initialize(bool bWaitForActivate = true) { return false; }
+	bool IsRunning() const { return false; }
+
+	CNetConfig *GetConfig() { return &m_Config; }
+	const char *GetHostname() const { return m_pHostname; }
+
+	static CNetSubSystem *Get() { return nullptr; }
+
+private:
+	const char *m_pHostname;
+	CNetConfig m_Config;
+};
@@ -0,0 +1,34 @@
+//
+// net/socket.h
+//
+// Host replacement of the Circle socket, whose calls fail
+//
+#pragma once
+
+#include <circle/net/in.h>
+#include <circle/net/ipaddress.h>
+#include <circle/net/netsubsystem.h>
+#include <circle/types.h>
+
+class CSocket
+{
+public:
+	CSocket(CNetSubSystem *pNetSubSystem, int nProtocol) {}
+
+	int Bind(u16 nOwnPort) { return -1; }
+	int Connect(const CIPAddress &rForeignIP, u16 nForeignPort) { return -1; }
+	int Listen(unsigned nBackLog = 4) { return -1; }
+	CSocket *Accept(CIPAddress *pForeignIP, u16 *pForeignPort) { return nullptr; }
+
+	int Send(const void *pBuffer, unsigned nLength, int nFlags) { return -1; }
+	int Receive(void *pBuffer, unsigned nLength, int nFlags) { return -1; }
+	int SendTo(const void *pBuffer, unsigned nLength, int nFlags, const CIPAddress &rForeignIP, u16 nForeignPort) { return -1; }
+	int ReceiveFrom(void *pBuffer, unsigned nLength, int nFlags, CIPAddress *pForeignIP, u16 *pForeignPort) { return -1; }
+
+	int SetOptionBroadcast(bool bAllowed) { return -1; }
+
+	const u8 *GetForeignIP() const { return m_ForeignIP.Get(); }
+
+private:
+	CIPAddress m_ForeignIP;
+};
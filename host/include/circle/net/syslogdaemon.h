@@ -0,0 +1,16 @@
+//
+// net/syslogdaemon.h
+//
+// Host replacement of the Circle syslog daemon
+//
+#pragma once
+
+#include <circle/net/ipaddress.h>
+#include <circle/net/netsubsystem.h>
+#include <circle/types.h>
+
+class CSysLogDaemon
+{
+public:
+	CSysLogDaemon(CNetSubSystem *pNetSubSystem, const CIPAddress &rServerIP, u16 usServerPort = 514) {}
+};
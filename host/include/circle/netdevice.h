@@ -0,0 +1,25 @@
+//
+// netdevice.h
+//
+// Host replacement of the Circle network device
+//
+#pragma once
+
+enum TNetDeviceType
+{
+	NetDeviceTypeEthernet,
+	NetDeviceTypeWLAN,
+	NetDeviceTypeAny,
+	NetDeviceTypeUnknown
+};
+
+class CNetDevice
+{
+public:
+	virtual ~CNetDevice() {}
+
+	virtual TNetDeviceType GetType() { return NetDeviceTypeUnknown; }
+	virtual bool IsLinkUp() { return false; }
+
+	static CNetDevice *GetNetDevice(TNetDeviceType Type) { return nullptr; }
+};
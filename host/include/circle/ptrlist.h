@@ -0,0 +1,67 @@
+//
+// ptrlist.h
+//
+// Host replacement of the Circle pointer list
+//
+#pragma once
+
+struct TPtrListElement
+{
+	void *pPtr;
+	TPtrListElement *pPrev;
+	TPtrListElement *pNext;
+};
+
+class CPtrList
+{
+public:
+	CPtrList() :
+	m_pFirst{}
+	{
+	}
+
+	~CPtrList()
+	{
+		while (m_pFirst)
+		{
+			Remove(m_pFirst);
+		}
+	}
+
+	TPtrListElement *GetFirst() { return m_pFirst; }
+	TPtrListElement *GetNext(TPtrListElement *pElement) { return pElement->pNext; }
+
+	static void *GetPtr(TPtrListElement *pElement) { return pElement->pPtr; }
+
+	void InsertBefore(TPtrListElement *pAfter, void *pPtr)
+	{
+		TPtrListElement *pElement = new TPtrListElement{pPtr, pAfter->pPrev, pAfter};
+		(pAfter->pPrev ? pAfter->pPrev->pNext : m_pFirst) = pElement;
+		pAfter->pPrev = pElement;
+	}
+
+	// inserts at the front, if pBefore is nullptr
+	void InsertAfter(TPtrListElement *pBefore, void *pPtr)
+	{
+		TPtrListElement *pNext = pBefore ? pBefore->pNext : m_pFirst;
+		TPtrListElement *pElement = new TPtrListElement{pPtr, pBefore, pNext};
+		(pBefore ? pBefore->pNext : m_pFirst) = pElement;
+		if (pNext)
+		{
+			pNext->pPrev = pElement;
+		}
+	}
+
+	void Remove(TPtrListElement *pElement)
+	{
+		(pElement->pPrev ? pElement->pPrev->pNext : m_pFirst) = pElement->pNext;
+		if (pElement->pNext)
+		{
+			pElement->pNext->pPrev = pElement->pPrev;
+		}
+		delete pElement;
+	}
+
+private:
+	TPtrListElement *m_pFirst;
+};
@@ -0,0 +1,18 @@
+//
+// sched/mutex.h
+//
+// Host replacement of the Circle mutex
+//
+#pragma once
+
+#include <mutex>
+
+class CMutex
+{
+public:
+	void Acquire() { m_Mutex.lock(); }
+	void Release() { m_Mutex.unlock(); }
+
+private:
+	std::recursive_mutex m_Mutex;
+};
@@ -0,0 +1,25 @@
+//
+// sched/scheduler.h
+//
+// Host replacement of the Circle scheduler. Tasks never run, as only the
+// network uses them.
+//
+#pragma once
+
+#include <circle/sched/task.h>
+#include <circle/timer.h>
+
+class CScheduler
+{
+public:
+	static CScheduler *Get()
+	{
+		static CScheduler s_Scheduler;
+		return &s_Scheduler;
+	}
+
+	void Yield() {}
+	void Sleep(unsigned nSeconds) { CTimer::SimpleMsDelay(nSeconds * 1000); }
+	void MsSleep(unsigned nMilliSeconds) { CTimer::SimpleMsDelay(nMilliSeconds); }
+	void usSleep(unsigned nMicroSeconds) { CTimer::SimpleusDelay(nMicroSeconds); }
+};
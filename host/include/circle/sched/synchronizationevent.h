@@ -0,0 +1,56 @@
+//
+// sched/synchronizationevent.h
+//
+// Host replacement of the Circle synchronization event
+//
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+class CSynchronizationEvent
+{
+public:
+	CSynchronizationEvent(bool bState = false) :
+	m_bState{bState}
+	{
+	}
+
+	bool GetState()
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		return m_bState;
+	}
+
+	void Clear()
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_bState = false;
+	}
+
+	void Set()
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_bState = true;
+		m_Condition.notify_all();
+	}
+
+	void Wait()
+	{
+		std::unique_lock<std::mutex> Lock(m_Mutex);
+		m_Condition.wait(Lock, [this] { return m_bState; });
+	}
+
+	// returns true on timeout
+	bool WaitWithTimeout(unsigned nMicroSeconds)
+	{
+		std::unique_lock<std::mutex> Lock(m_Mutex);
+		return !m_Condition.wait_for(Lock, std::chrono::microseconds(nMicroSeconds), [this] { return m_bState; });
+	}
+
+private:
+	bool m_bState;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+};
@@ -0,0 +1,23 @@
+//
+// sched/task.h
+//
+// Host replacement of the Circle task, which never runs
+//
+#pragma once
+
+#define TASK_STACK_SIZE 0x8000
+
+class CTask
+{
+public:
+	CTask(unsigned nStackSize = TASK_STACK_SIZE, bool bCreateSuspended = false) {}
+	virtual ~CTask() {}
+
+	virtual void Run() {}
+
+	void Start() {}
+	void Terminate() {}
+	void WaitForTermination() {}
+
+	void SetName(const char *pName) {}
+};
@@ -0,0 +1,45 @@
+//
+// serial.h
+//
+// Host replacement of the Circle serial device. The renderer sends the
+// MIDI events through it, so that CSerialMIDIDevice parses them.
+//
+#pragma once
+
+#include <circle/device.h>
+#include <circle/interrupt.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+#define SERIAL_OPTION_ONLCR (1 << 0)
+
+class CSerialDevice : public CDevice
+{
+public:
+	CSerialDevice(CInterruptSystem *pInterruptSystem = nullptr, bool bUseFIQ = false, unsigned nDevice = 0);
+	~CSerialDevice() override;
+
+	bool Initialize(unsigned nBaudrate = 115200, unsigned nDataBits = 8, unsigned nStopBits = 1, int Parity = 0);
+
+	int Read(void *pBuffer, size_t nCount) override;
+	int Write(const void *pBuffer, size_t nCount) override;
+
+	unsigned GetOptions() const { return m_nOptions; }
+	void SetOptions(unsigned nOptions) { m_nOptions = nOptions; }
+
+	// host only, the device initialized last
+	static CSerialDevice *GetHost();
+
+	// queues bytes for Read()
+	void Receive(const uint8_t *pBuffer, size_t nCount);
+
+private:
+	unsigned m_nOptions;
+
+	std::mutex m_Mutex;
+	std::deque<uint8_t> m_RxQueue;
+
+	static CSerialDevice *s_pHost;
+};
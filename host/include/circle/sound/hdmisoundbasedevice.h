@@ -0,0 +1,18 @@
+//
+// hdmisoundbasedevice.h
+//
+// Host replacement of the Circle HDMI sound device
+//
+#pragma once
+
+#include <circle/interrupt.h>
+#include <circle/sound/soundbasedevice.h>
+
+class CHDMISoundBaseDevice : public CSoundBaseDevice
+{
+public:
+	CHDMISoundBaseDevice(CInterruptSystem *pInterrupt, unsigned nSampleRate = 48000, unsigned nChunkSize = 384 * 10) :
+	CSoundBaseDevice{nSampleRate, nChunkSize}
+	{
+	}
+};
@@ -0,0 +1,31 @@
+//
+// i2ssoundbasedevice.h
+//
+// Host replacement of the Circle I2S sound device
+//
+#pragma once
+
+#include <cstdint>
+
+#include <circle/i2cmaster.h>
+#include <circle/interrupt.h>
+#include <circle/sound/soundbasedevice.h>
+
+class CI2SSoundBaseDevice : public CSoundBaseDevice
+{
+public:
+	enum TDeviceMode
+	{
+		DeviceModeTXOnly,
+		DeviceModeRXOnly,
+		DeviceModeTXRX,
+		DeviceModeUnknown
+	};
+
+	CI2SSoundBaseDevice(CInterruptSystem *pInterrupt, unsigned nSampleRate = 192000, unsigned nChunkSize = 8192,
+			    bool bSlave = false, CI2CMaster *pI2CMaster = nullptr, uint8_t ucI2CAddress = 0,
+			    TDeviceMode DeviceMode = DeviceModeTXOnly, unsigned nHWChannels = 2) :
+	CSoundBaseDevice{nSampleRate, nChunkSize}
+	{
+	}
+};
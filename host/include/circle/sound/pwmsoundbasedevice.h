@@ -0,0 +1,18 @@
+//
+// pwmsoundbasedevice.h
+//
+// Host replacement of the Circle PWM sound device
+//
+#pragma once
+
+#include <circle/interrupt.h>
+#include <circle/sound/soundbasedevice.h>
+
+class CPWMSoundBaseDevice : public CSoundBaseDevice
+{
+public:
+	CPWMSoundBaseDevice(CInterruptSystem *pInterrupt, unsigned nSampleRate = 44100, unsigned nChunkSize = 2048) :
+	CSoundBaseDevice{nSampleRate, nChunkSize}
+	{
+	}
+};
@@ -0,0 +1,77 @@
+//
+// soundbasedevice.h
+//
+// Host replacement of the Circle sound device. The renderer takes the place
+// of the DMA: each transfer takes one chunk from the queue and then calls
+// the need data callback, as the interrupt of the device does.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+enum TSoundFormat
+{
+	SoundFormatUnsigned8,
+	SoundFormatSigned16,
+	SoundFormatSigned24,
+	SoundFormatSigned24_32,
+	SoundFormatUnsigned32,
+	SoundFormatUnknown
+};
+
+typedef void TSoundDataCallback(void *pParam);
+
+class CSoundBaseDevice
+{
+public:
+	CSoundBaseDevice(unsigned nSampleRate, unsigned nChunkSize);
+	virtual ~CSoundBaseDevice();
+
+	virtual bool Start();
+	virtual void Cancel();
+	virtual bool IsActive() const;
+
+	bool AllocateQueue(unsigned nSizeMsecs);
+	bool AllocateQueueFrames(unsigned nSizeFrames);
+
+	void SetWriteFormat(TSoundFormat Format, unsigned nChannels = 2);
+
+	// returns the bytes written, which are less, if the queue is full
+	int Write(const void *pBuffer, size_t nCount);
+
+	unsigned GetQueueSizeFrames();
+	unsigned GetQueueFramesAvail(); // queued
+
+	void RegisterNeedDataCallback(TSoundDataCallback *pCallback, void *pParam);
+
+	// host only, the device started last
+	static CSoundBaseDevice *GetHost();
+
+	unsigned GetSampleRate() const { return m_nSampleRate; }
+	unsigned GetChannels() const { return m_nChannels; }
+	unsigned GetChunkFrames() const { return m_nChunkSize / m_nChannels; }
+
+	// takes one chunk (Q23 in 32 bits) from the queue, missing frames are
+	// zero, returns the frames taken, then calls the need data callback
+	unsigned Transfer(int32_t *pBuffer);
+
+private:
+	unsigned m_nSampleRate;
+	unsigned m_nChunkSize; // samples of all channels
+	unsigned m_nChannels;
+	bool m_bActive;
+
+	std::mutex m_QueueMutex;
+	std::vector<int32_t> m_Queue; // ring buffer of frames
+	size_t m_nQueueSizeFrames;
+	size_t m_nReadFrame;
+	size_t m_nQueuedFrames;
+
+	TSoundDataCallback *m_pCallback;
+	void *m_pCallbackParam;
+
+	static CSoundBaseDevice *s_pHost;
+};
@@ -0,0 +1,14 @@
+//
+// spimaster.h
+//
+// Host replacement of the Circle SPI master, which has no devices
+//
+#pragma once
+
+class CSPIMaster
+{
+public:
+	CSPIMaster(unsigned nClockSpeed = 500000, unsigned CPOL = 0, unsigned CPHA = 0, unsigned nDevice = 0) {}
+
+	bool Initialize() { return true; }
+};
@@ -0,0 +1,26 @@
+//
+// spinlock.h
+//
+// Host replacement of the Circle spin lock.
+//
+#pragma once
+
+#include <atomic>
+
+class CSpinLock
+{
+public:
+	CSpinLock(unsigned nTargetLevel = 0) {}
+
+	void Acquire()
+	{
+		while (m_bLocked.test_and_set(std::memory_order_acquire))
+		{
+		}
+	}
+
+	void Release() { m_bLocked.clear(std::memory_order_release); }
+
+private:
+	std::atomic_flag m_bLocked = ATOMIC_FLAG_INIT;
+};
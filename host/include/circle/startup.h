@@ -0,0 +1,11 @@
+//
+// startup.h
+//
+// Host replacement of the Circle system functions
+//
+#pragma once
+
+#include <cstdlib>
+
+[[noreturn]] inline void halt() { exit(EXIT_FAILURE); }
+[[noreturn]] inline void reboot() { exit(EXIT_SUCCESS); }
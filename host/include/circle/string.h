@@ -0,0 +1,60 @@
+//
+// string.h
+//
+// Host replacement of the Circle string
+//
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+class CString
+{
+public:
+	CString() {}
+	CString(const char *pString) : m_String{pString} {}
+
+	operator const char *() const { return m_String.c_str(); }
+	const char *c_str() const { return m_String.c_str(); }
+
+	const char *operator=(const char *pString)
+	{
+		m_String = pString;
+		return m_String.c_str();
+	}
+
+	size_t GetLength() const { return m_String.length(); }
+
+	void Append(const char *pString) { m_String += pString; }
+	int Compare(const char *pString) const { return strcmp(m_String.c_str(), pString); }
+
+	int Find(char chChar) const
+	{
+		size_t nPos = m_String.find(chChar);
+		return nPos == std::string::npos ? -1 : static_cast<int>(nPos);
+	}
+
+	void Format(const char *pFormat, ...)
+	{
+		va_list var;
+		va_start(var, pFormat);
+		FormatV(pFormat, var);
+		va_end(var);
+	}
+
+	void FormatV(const char *pFormat, va_list Args)
+	{
+		va_list Args2;
+		va_copy(Args2, Args);
+		int nLen = vsnprintf(nullptr, 0, pFormat, Args2);
+		va_end(Args2);
+
+		m_String.resize(nLen);
+		vsnprintf(&m_String[0], nLen + 1, pFormat, Args);
+	}
+
+private:
+	std::string m_String;
+};
@@ -0,0 +1,18 @@
+//
+// synchronize.h
+//
+// Host replacement of the Circle synchronization. Core 0 is the main thread
+// of the renderer, which has no IRQs, so the critical sections are empty.
+// An event wakes up all cores waiting in WaitForEvent(), which also returns
+// after 100 microseconds, as the timer event stream does on the device.
+//
+#pragma once
+
+inline void EnterCritical() {}
+inline void LeaveCritical() {}
+
+void SendEvent();
+void WaitForEvent();
+
+#define DataSyncBarrier() __sync_synchronize()
+#define DataMemBarrier() __sync_synchronize()
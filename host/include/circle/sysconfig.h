@@ -0,0 +1,11 @@
+//
+// sysconfig.h
+//
+// Host replacement of the Circle system configuration: the audio path is
+// built for four cores, which are threads of the renderer.
+//
+#pragma once
+
+#define ARM_ALLOW_MULTI_CORE
+
+#define CORES 4
@@ -0,0 +1,43 @@
+//
+// timer.h
+//
+// Host replacement of the Circle timer. The clock is the time of the audio,
+// which the renderer sets at each MIDI event and each DMA interrupt of the
+// sound device. While it runs, the real time passes on top of it, so that
+// the stages of a block are timed in real microseconds. The renderer sets
+// it only while the audio cores are idle. Kernel timers never fire.
+//
+#pragma once
+
+#include <cstdint>
+
+#define CLOCKHZ 1000000
+
+#define HZ 100
+#define MSEC2HZ(msecs) ((msecs) * HZ / 1000)
+
+typedef uintptr_t TKernelTimerHandle;
+typedef void TKernelTimerHandler(TKernelTimerHandle hTimer, void *pParam, void *pContext);
+
+class CTimer
+{
+public:
+	static CTimer *Get();
+
+	static unsigned GetClockTicks();
+
+	unsigned GetTicks() const { return GetClockTicks() / (CLOCKHZ / HZ); }
+	unsigned GetUptime() const { return GetClockTicks() / CLOCKHZ; }
+
+	TKernelTimerHandle StartKernelTimer(unsigned nDelay, TKernelTimerHandler *pHandler,
+					    void *pParam = nullptr, void *pContext = nullptr);
+	void CancelKernelTimer(TKernelTimerHandle hTimer);
+
+	void MsDelay(unsigned nMilliSeconds) { SimpleMsDelay(nMilliSeconds); }
+	void usDelay(unsigned nMicroSeconds) { SimpleusDelay(nMicroSeconds); }
+	static void SimpleMsDelay(unsigned nMilliSeconds);
+	static void SimpleusDelay(unsigned nMicroSeconds);
+
+	// host only, the clock stands still at nTicks, until it is set running
+	static void SetClockTicks(unsigned nTicks, bool bRunning);
+};
@@ -0,0 +1,25 @@
+//
+// types.h
+//
+// Host replacement of the Circle types.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+typedef uintptr_t uintptr;
+
+typedef bool boolean;
+#define FALSE false
+#define TRUE true
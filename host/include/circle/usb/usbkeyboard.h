@@ -0,0 +1,18 @@
+//
+// circle/usb/usbkeyboard.h
+//
+// Host replacement of the Circle USB keyboard, which is never attached
+//
+#pragma once
+
+#include <circle/device.h>
+
+typedef void TKeyStatusHandlerRaw(unsigned char ucModifiers, const unsigned char RawKeys[6]);
+typedef void TDeviceRemovedHandler(CDevice *pDevice, void *pContext);
+
+class CUSBKeyboardDevice : public CDevice
+{
+public:
+	void RegisterKeyStatusHandlerRaw(TKeyStatusHandlerRaw *pKeyStatusHandlerRaw, bool bMixedMode = false) {}
+	void RegisterRemovedHandler(TDeviceRemovedHandler *pHandler, void *pContext = nullptr) {}
+};
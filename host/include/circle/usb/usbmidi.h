@@ -0,0 +1,21 @@
+//
+// circle/usb/usbmidi.h
+//
+// Host replacement of the Circle USB MIDI device, which is never attached
+//
+#pragma once
+
+#include <circle/device.h>
+#include <circle/types.h>
+
+typedef void TMIDIPacketHandler(unsigned nCable, u8 *pPacket, unsigned nLength, unsigned nDevice, void *pParam);
+typedef void TDeviceRemovedHandler(CDevice *pDevice, void *pContext);
+
+class CUSBMIDIDevice : public CDevice
+{
+public:
+	void RegisterPacketHandler(TMIDIPacketHandler *pPacketHandler, void *pParam = nullptr) {}
+	void RegisterRemovedHandler(TDeviceRemovedHandler *pHandler, void *pContext = nullptr) {}
+
+	bool SendPlainMIDI(unsigned nCable, const u8 *pData, unsigned nLength) { return false; }
+};
@@ -0,0 +1,14 @@
+//
+// util.h
+//
+// Host replacement of the Circle utility functions
+//
+#pragma once
+
+#include <cstring>
+
+#define bswap16 __builtin_bswap16
+#define bswap32 __builtin_bswap32
+
+#define le2be16 bswap16
+#define le2be32 bswap32
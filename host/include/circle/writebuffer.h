@@ -0,0 +1,24 @@
+//
+// writebuffer.h
+//
+// Host replacement of the Circle write buffer, which writes through
+//
+#pragma once
+
+#include <circle/device.h>
+
+class CWriteBufferDevice : public CDevice
+{
+public:
+	CWriteBufferDevice(CDevice *pDevice) :
+	m_pDevice{pDevice}
+	{
+	}
+
+	int Write(const void *pBuffer, size_t nCount) override { return m_pDevice->Write(pBuffer, nCount); }
+
+	void Update() {}
+
+private:
+	CDevice *m_pDevice;
+};
@@ -0,0 +1,16 @@
+//
+// display/chardevice.h
+//
+// Host replacement of the Circle character display, which prints nothing
+//
+#pragma once
+
+#include <circle/device.h>
+
+class CCharDevice : public CDevice
+{
+public:
+	virtual bool Initialize() { return true; }
+
+	int Write(const void *pBuffer, size_t nCount) override { return static_cast<int>(nCount); }
+};
@@ -0,0 +1,18 @@
+//
+// display/hd44780device.h
+//
+// Host replacement of the Circle HD44780 display
+//
+#pragma once
+
+#include <circle/i2cmaster.h>
+#include <circle/types.h>
+#include <display/chardevice.h>
+
+class CHD44780Device : public CCharDevice
+{
+public:
+	CHD44780Device(unsigned nColumns, unsigned nRows, unsigned nD4Pin, unsigned nD5Pin, unsigned nD6Pin, unsigned nD7Pin,
+		       unsigned nENPin, unsigned nRSPin, unsigned nRWPin = 0, bool bBlockCursor = false) {}
+	CHD44780Device(CI2CMaster *pI2CMaster, u8 nAddress, unsigned nColumns, unsigned nRows, bool bBlockCursor = false) {}
+};
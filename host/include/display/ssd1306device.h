@@ -0,0 +1,17 @@
+//
+// display/ssd1306device.h
+//
+// Host replacement of the Circle SSD1306 display
+//
+#pragma once
+
+#include <circle/i2cmaster.h>
+#include <circle/types.h>
+#include <display/chardevice.h>
+
+class CSSD1306Device : public CCharDevice
+{
+public:
+	CSSD1306Device(unsigned nWidth, unsigned nHeight, CI2CMaster *pI2CMaster, u8 nAddress = 0x3C,
+		       bool bRotate = false, bool bMirror = false) {}
+};
@@ -0,0 +1,18 @@
+//
+// display/st7789device.h
+//
+// Host replacement of the Circle ST7789 character display
+//
+#pragma once
+
+#include <circle/font.h>
+#include <circle/spimaster.h>
+#include <display/chardevice.h>
+#include <display/st7789display.h>
+
+class CST7789Device : public CCharDevice
+{
+public:
+	CST7789Device(CSPIMaster *pSPIMaster, CST7789Display *pST7789Display, unsigned nColumns, unsigned nRows,
+		      const TFont &rFont, bool bDoubleWidth = false, bool bDoubleHeight = false, bool bBlockCursor = false) {}
+};
@@ -0,0 +1,20 @@
+//
+// display/st7789display.h
+//
+// Host replacement of the Circle ST7789 display
+//
+#pragma once
+
+#include <circle/spimaster.h>
+
+class CST7789Display
+{
+public:
+	CST7789Display(CSPIMaster *pSPIMaster, unsigned nDCPin, unsigned nResetPin = 0, unsigned nBackLightPin = 0,
+		       unsigned nWidth = 240, unsigned nHeight = 240, unsigned CPOL = 0, unsigned CPHA = 0,
+		       unsigned nClockSpeed = 15000000, unsigned nChipSelect = 0, bool bSwapColorBytes = true) {}
+
+	bool Initialize() { return true; }
+
+	void SetRotation(unsigned nRot) {}
+};
@@ -0,0 +1,16 @@
+//
+// hostcompat.h
+//
+// Included before each source. The C++ library of the host may lack the
+// float functions in std, which newlib has.
+//
+#pragma once
+
+#ifdef __cplusplus
+#include <cmath>
+
+namespace std
+{
+using ::powf;
+}
+#endif
@@ -0,0 +1,35 @@
+//
+// sensor/ky040.h
+//
+// Host replacement of the Circle KY-040 rotary encoder, which sends no events
+//
+#pragma once
+
+#include <circle/gpiomanager.h>
+
+class CKY040
+{
+public:
+	enum TEvent
+	{
+		EventClockwise,
+		EventCounterclockwise,
+		EventSwitchDown,
+		EventSwitchUp,
+		EventSwitchClick,
+		EventSwitchDoubleClick,
+		EventSwitchTripleClick,
+		EventSwitchHold,
+		EventUnknown
+	};
+
+	typedef void TEventHandler(TEvent Event, void *pParam);
+
+	CKY040(unsigned nCLKPin, unsigned nDTPin, unsigned nSWPin, CGPIOManager *pGPIOManager = nullptr, unsigned nDetents = 1) {}
+
+	bool Initialize() { return true; }
+
+	void RegisterEventHandler(TEventHandler *pHandler, void *pParam = nullptr) {}
+
+	unsigned GetHoldSeconds() const { return 0; }
+};
@@ -0,0 +1,38 @@
+//
+// dirent.h
+//
+// The directory functions of the newlib of Circle are in <dirent.h> on the host.
+// The FatFs directories of Circle have no "." and ".." entries, which are skipped here.
+// The root of the SD card, which newlib opens the absolute paths in, is the
+// working directory of the host.
+//
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+
+inline const char *HostPath(const char *pPath)
+{
+	while (*pPath == '/')
+	{
+		pPath++;
+	}
+
+	return *pPath ? pPath : ".";
+}
+
+inline struct dirent *HostReadDir(DIR *pDirectory)
+{
+	struct dirent *pEntry;
+	while ((pEntry = readdir(pDirectory)) != nullptr &&
+	       (strcmp(pEntry->d_name, ".") == 0 || strcmp(pEntry->d_name, "..") == 0))
+	{
+	}
+
+	return pEntry;
+}
+
+#define readdir HostReadDir
+#define opendir(name) opendir(HostPath(name))
+#define fopen(name, mode) fopen(HostPath(name), mode)
@@ -0,0 +1,14 @@
+//
+// wlan/bcm4343.h
+//
+// Host replacement of the Circle WLAN device
+//
+#pragma once
+
+class CBcm4343Device
+{
+public:
+	CBcm4343Device(const char *pFirmwarePath) {}
+
+	bool Initialize() { return false; }
+};
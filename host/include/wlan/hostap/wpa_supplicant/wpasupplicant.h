@@ -0,0 +1,15 @@
+//
+// wlan/hostap/wpa_supplicant/wpasupplicant.h
+//
+// Host replacement of the Circle WPA supplicant
+//
+#pragma once
+
+class CWPASupplicant
+{
+public:
+	CWPASupplicant(const char *pConfigFile) {}
+
+	bool Initialize() { return false; }
+	bool IsConnected() const { return false; }
+};
@@ -0,0 +1,215 @@
+//
+// ff.cpp
+//
+// Host replacement of FatFs
+//
+#include <fatfs/ff.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fnmatch.h>
+#include <string>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+// "SD:/performance" and "/performance" are "performance" in the working directory
+static fs::path GetHostPath(const TCHAR *pPath)
+{
+	const char *pColon = strchr(pPath, ':');
+	if (pColon)
+	{
+		pPath = pColon + 1;
+	}
+
+	while (*pPath == '/')
+	{
+		pPath++;
+	}
+
+	return *pPath ? fs::path(pPath) : fs::path(".");
+}
+
+static void GetFileInfo(const fs::directory_entry &Entry, FILINFO *fno)
+{
+	std::error_code Error;
+
+	memset(fno, 0, sizeof *fno);
+	snprintf(fno->fname, sizeof fno->fname, "%s", Entry.path().filename().c_str());
+
+	if (Entry.is_directory(Error))
+	{
+		fno->fattrib = AM_DIR;
+	}
+	else
+	{
+		fno->fattrib = AM_ARC;
+		fno->fsize = Entry.file_size(Error);
+	}
+}
+
+FRESULT f_open(FIL *fp, const TCHAR *path, BYTE mode)
+{
+	const char *pMode = mode & FA_CREATE_ALWAYS ? (mode & FA_READ ? "w+b" : "wb")
+			    : mode & FA_WRITE	    ? "r+b"
+						    : "rb";
+
+	FILE *pFile = fopen(GetHostPath(path).c_str(), pMode);
+	if (!pFile && (mode & (FA_OPEN_ALWAYS | FA_CREATE_NEW)))
+	{
+		pFile = fopen(GetHostPath(path).c_str(), "w+b");
+	}
+
+	if (!pFile)
+	{
+		return FR_NO_FILE;
+	}
+
+	fseek(pFile, 0, SEEK_END);
+	fp->fsize = static_cast<FSIZE_t>(ftell(pFile));
+	fseek(pFile, 0, (mode & FA_OPEN_APPEND) == FA_OPEN_APPEND ? SEEK_END : SEEK_SET);
+	fp->pFile = pFile;
+
+	return FR_OK;
+}
+
+FRESULT f_close(FIL *fp)
+{
+	FILE *pFile = static_cast<FILE *>(fp->pFile);
+	fp->pFile = nullptr;
+
+	return pFile && fclose(pFile) == 0 ? FR_OK : FR_DISK_ERR;
+}
+
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br)
+{
+	*br = static_cast<UINT>(fread(buff, 1, btr, static_cast<FILE *>(fp->pFile)));
+
+	return ferror(static_cast<FILE *>(fp->pFile)) ? FR_DISK_ERR : FR_OK;
+}
+
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw)
+{
+	*bw = static_cast<UINT>(fwrite(buff, 1, btw, static_cast<FILE *>(fp->pFile)));
+
+	return *bw == btw ? FR_OK : FR_DISK_ERR;
+}
+
+FRESULT f_sync(FIL *fp)
+{
+	return fflush(static_cast<FILE *>(fp->pFile)) == 0 ? FR_OK : FR_DISK_ERR;
+}
+
+FRESULT f_opendir(DIR *dp, const TCHAR *path)
+{
+	return f_findfirst(dp, nullptr, path, "*");
+}
+
+FRESULT f_closedir(DIR *dp)
+{
+	delete static_cast<fs::directory_iterator *>(dp->pIterator);
+	dp->pIterator = nullptr;
+
+	return FR_OK;
+}
+
+FRESULT f_readdir(DIR *dp, FILINFO *fno)
+{
+	fs::directory_iterator *pIterator = static_cast<fs::directory_iterator *>(dp->pIterator);
+	if (!pIterator)
+	{
+		return FR_INVALID_OBJECT;
+	}
+
+	std::error_code Error;
+	for (; *pIterator != fs::directory_iterator(); pIterator->increment(Error))
+	{
+		if (fnmatch(dp->Pattern, (*pIterator)->path().filename().c_str(), FNM_CASEFOLD) == 0)
+		{
+			GetFileInfo(**pIterator, fno);
+			pIterator->increment(Error);
+
+			return FR_OK;
+		}
+	}
+
+	fno->fname[0] = '\0'; // end of the directory
+
+	return FR_OK;
+}
+
+FRESULT f_findfirst(DIR *dp, FILINFO *fno, const TCHAR *path, const TCHAR *pattern)
+{
+	std::error_code Error;
+	fs::directory_iterator Iterator(GetHostPath(path), Error);
+	if (Error)
+	{
+		dp->pIterator = nullptr;
+
+		return FR_NO_PATH;
+	}
+
+	dp->pIterator = new fs::directory_iterator(std::move(Iterator));
+	snprintf(dp->Pattern, sizeof dp->Pattern, "%s", pattern);
+
+	return fno ? f_readdir(dp, fno) : FR_OK;
+}
+
+FRESULT f_findnext(DIR *dp, FILINFO *fno)
+{
+	return f_readdir(dp, fno);
+}
+
+FRESULT f_mkdir(const TCHAR *path)
+{
+	std::error_code Error;
+	if (fs::exists(GetHostPath(path), Error))
+	{
+		return FR_EXIST;
+	}
+
+	return fs::create_directory(GetHostPath(path), Error) ? FR_OK : FR_NO_PATH;
+}
+
+FRESULT f_unlink(const TCHAR *path)
+{
+	std::error_code Error;
+
+	return fs::remove(GetHostPath(path), Error) ? FR_OK : FR_NO_FILE;
+}
+
+FRESULT f_rename(const TCHAR *path_old, const TCHAR *path_new)
+{
+	std::error_code Error;
+	fs::rename(GetHostPath(path_old), GetHostPath(path_new), Error);
+
+	return Error ? FR_NO_FILE : FR_OK;
+}
+
+FRESULT f_stat(const TCHAR *path, FILINFO *fno)
+{
+	std::error_code Error;
+	fs::directory_entry Entry(GetHostPath(path), Error);
+	if (Error || !Entry.exists(Error))
+	{
+		return FR_NO_FILE;
+	}
+
+	if (fno)
+	{
+		GetFileInfo(Entry, fno);
+	}
+
+	return FR_OK;
+}
+
+FRESULT f_mount(FATFS *fs, const TCHAR *path, BYTE opt)
+{
+	return FR_OK;
+}
+
+FRESULT f_chdrive(const TCHAR *path)
+{
+	return FR_OK;
+}
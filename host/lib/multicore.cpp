@@ -0,0 +1,81 @@
+//
+// multicore.cpp
+//
+// Host replacement of the Circle multi core support
+//
+#include <circle/multicore.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+static std::mutex s_EventMutex;
+static std::condition_variable s_Event;
+static unsigned s_nEvents = 0;
+static unsigned s_nWaitingCores = 0;
+
+static thread_local unsigned s_nThisCore = 0;
+
+void SendEvent()
+{
+	{
+		std::lock_guard<std::mutex> Lock(s_EventMutex);
+		s_nEvents++;
+	}
+
+	s_Event.notify_all();
+}
+
+void WaitForEvent()
+{
+	std::unique_lock<std::mutex> Lock(s_EventMutex);
+	unsigned nEvents = s_nEvents;
+	s_nWaitingCores++;
+	s_Event.wait_for(Lock, std::chrono::microseconds(100), [nEvents] { return s_nEvents != nEvents; });
+	s_nWaitingCores--;
+}
+
+CMemorySystem *CMemorySystem::Get()
+{
+	static CMemorySystem s_MemorySystem;
+	return &s_MemorySystem;
+}
+
+CMultiCoreSupport::CMultiCoreSupport(CMemorySystem *pMemorySystem)
+{
+}
+
+CMultiCoreSupport::~CMultiCoreSupport()
+{
+}
+
+bool CMultiCoreSupport::Initialize()
+{
+	// the cores run until the renderer exits
+	for (unsigned nCore = 1; nCore < CORES; nCore++)
+	{
+		std::thread([this, nCore] {
+			s_nThisCore = nCore;
+			Run(nCore);
+		}).detach();
+	}
+
+	return true;
+}
+
+void CMultiCoreSupport::SendIPI(unsigned nCore, unsigned nIPI)
+{
+	SendEvent();
+}
+
+unsigned CMultiCoreSupport::GetWaitingCores()
+{
+	std::lock_guard<std::mutex> Lock(s_EventMutex);
+	return s_nWaitingCores;
+}
+
+unsigned CMultiCoreSupport::ThisCore()
+{
+	return s_nThisCore;
+}
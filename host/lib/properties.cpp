@@ -0,0 +1,202 @@
+//
+// properties.cpp
+//
+// Host replacement of the Circle properties in a FatFs file
+//
+#include <Properties/propertiesfatfsfile.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+CPropertiesFatFsFile::CPropertiesFatFsFile(const char *pFileName, FATFS *pFileSystem) :
+m_FileName{pFileName},
+m_IPAddress{}
+{
+}
+
+bool CPropertiesFatFsFile::Load()
+{
+	RemoveAll();
+
+	FIL File;
+	if (f_open(&File, m_FileName.c_str(), FA_READ | FA_OPEN_EXISTING) != FR_OK)
+	{
+		return false;
+	}
+
+	std::string Text(f_size(&File), '\0');
+	UINT nRead;
+	FRESULT Result = f_read(&File, Text.data(), static_cast<UINT>(Text.size()), &nRead);
+	f_close(&File);
+	if (Result != FR_OK)
+	{
+		return false;
+	}
+
+	size_t nPos = 0;
+	while (nPos < Text.size())
+	{
+		size_t nEnd = Text.find('\n', nPos);
+		if (nEnd == std::string::npos)
+		{
+			nEnd = Text.size();
+		}
+
+		std::string Line = Text.substr(nPos, nEnd - nPos);
+		nPos = nEnd + 1;
+
+		size_t nHash = Line.find('#');
+		if (nHash != std::string::npos)
+		{
+			Line.erase(nHash);
+		}
+
+		size_t nEqual = Line.find('=');
+		if (nEqual == std::string::npos)
+		{
+			continue;
+		}
+
+		auto Trim = [](std::string String) {
+			size_t nFirst = String.find_first_not_of(" \t\r");
+			size_t nLast = String.find_last_not_of(" \t\r");
+			return nFirst == std::string::npos ? std::string() : String.substr(nFirst, nLast - nFirst + 1);
+		};
+
+		std::string Name = Trim(Line.substr(0, nEqual));
+		if (!Name.empty())
+		{
+			SetString(Name.c_str(), Trim(Line.substr(nEqual + 1)).c_str());
+		}
+	}
+
+	return true;
+}
+
+bool CPropertiesFatFsFile::Save()
+{
+	FIL File;
+	if (f_open(&File, m_FileName.c_str(), FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
+	{
+		return false;
+	}
+
+	bool bOK = true;
+	for (const auto &Property : m_Properties)
+	{
+		std::string Line = Property.first + "=" + Property.second + "\n";
+		UINT nWritten;
+		bOK &= f_write(&File, Line.c_str(), static_cast<UINT>(Line.size()), &nWritten) == FR_OK;
+	}
+
+	return f_close(&File) == FR_OK && bOK;
+}
+
+void CPropertiesFatFsFile::RemoveAll()
+{
+	m_Properties.clear();
+}
+
+bool CPropertiesFatFsFile::IsSet(const char *pPropertyName) const
+{
+	return Find(pPropertyName) != nullptr;
+}
+
+const char *CPropertiesFatFsFile::GetString(const char *pPropertyName, const char *pDefault) const
+{
+	const std::string *pValue = Find(pPropertyName);
+
+	return pValue ? pValue->c_str() : pDefault;
+}
+
+unsigned CPropertiesFatFsFile::GetNumber(const char *pPropertyName, unsigned nDefault) const
+{
+	const std::string *pValue = Find(pPropertyName);
+	if (!pValue || pValue->empty())
+	{
+		return nDefault;
+	}
+
+	char *pEnd;
+	unsigned long nValue = strtoul(pValue->c_str(), &pEnd, 0);
+
+	return *pEnd ? nDefault : static_cast<unsigned>(nValue);
+}
+
+int CPropertiesFatFsFile::GetSignedNumber(const char *pPropertyName, int nDefault) const
+{
+	const std::string *pValue = Find(pPropertyName);
+	if (!pValue || pValue->empty())
+	{
+		return nDefault;
+	}
+
+	char *pEnd;
+	long nValue = strtol(pValue->c_str(), &pEnd, 10);
+
+	return *pEnd ? nDefault : static_cast<int>(nValue);
+}
+
+const uint8_t *CPropertiesFatFsFile::GetIPAddress(const char *pPropertyName) const
+{
+	const std::string *pValue = Find(pPropertyName);
+	unsigned Byte[4];
+	char chEnd;
+	if (!pValue || sscanf(pValue->c_str(), "%u.%u.%u.%u%c", &Byte[0], &Byte[1], &Byte[2], &Byte[3], &chEnd) != 4)
+	{
+		return nullptr;
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (Byte[i] > 255)
+		{
+			return nullptr;
+		}
+
+		m_IPAddress[i] = static_cast<uint8_t>(Byte[i]);
+	}
+
+	return m_IPAddress;
+}
+
+void CPropertiesFatFsFile::SetString(const char *pPropertyName, const char *pValue)
+{
+	for (auto &Property : m_Properties)
+	{
+		if (Property.first == pPropertyName)
+		{
+			Property.second = pValue;
+
+			return;
+		}
+	}
+
+	m_Properties.emplace_back(pPropertyName, pValue);
+}
+
+void CPropertiesFatFsFile::SetNumber(const char *pPropertyName, unsigned nValue, unsigned nBase)
+{
+	char Value[20];
+	snprintf(Value, sizeof Value, nBase == 16 ? "0x%X" : "%u", nValue);
+	SetString(pPropertyName, Value);
+}
+
+void CPropertiesFatFsFile::SetSignedNumber(const char *pPropertyName, int nValue)
+{
+	SetString(pPropertyName, std::to_string(nValue).c_str());
+}
+
+const std::string *CPropertiesFatFsFile::Find(const char *pPropertyName) const
+{
+	for (const auto &Property : m_Properties)
+	{
+		if (Property.first == pPropertyName)
+		{
+			return &Property.second;
+		}
+	}
+
+	return nullptr;
+}
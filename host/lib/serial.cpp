@@ -0,0 +1,61 @@
+//
+// serial.cpp
+//
+// Host replacement of the Circle serial device
+//
+#include <circle/serial.h>
+
+CSerialDevice *CSerialDevice::s_pHost = nullptr;
+
+CSerialDevice::CSerialDevice(CInterruptSystem *pInterruptSystem, bool bUseFIQ, unsigned nDevice) :
+m_nOptions{SERIAL_OPTION_ONLCR}
+{
+}
+
+CSerialDevice::~CSerialDevice()
+{
+	if (s_pHost == this)
+	{
+		s_pHost = nullptr;
+	}
+}
+
+bool CSerialDevice::Initialize(unsigned nBaudrate, unsigned nDataBits, unsigned nStopBits, int Parity)
+{
+	s_pHost = this;
+
+	return true;
+}
+
+int CSerialDevice::Read(void *pBuffer, size_t nCount)
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+
+	uint8_t *pData = static_cast<uint8_t *>(pBuffer);
+	size_t nRead = 0;
+
+	while (nRead < nCount && !m_RxQueue.empty())
+	{
+		pData[nRead++] = m_RxQueue.front();
+		m_RxQueue.pop_front();
+	}
+
+	return static_cast<int>(nRead);
+}
+
+int CSerialDevice::Write(const void *pBuffer, size_t nCount)
+{
+	return static_cast<int>(nCount);
+}
+
+CSerialDevice *CSerialDevice::GetHost()
+{
+	return s_pHost;
+}
+
+void CSerialDevice::Receive(const uint8_t *pBuffer, size_t nCount)
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+
+	m_RxQueue.insert(m_RxQueue.end(), pBuffer, pBuffer + nCount);
+}
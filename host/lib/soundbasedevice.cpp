@@ -0,0 +1,150 @@
+//
+// soundbasedevice.cpp
+//
+// Host replacement of the Circle sound device
+//
+#include <circle/sound/soundbasedevice.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+CSoundBaseDevice *CSoundBaseDevice::s_pHost = nullptr;
+
+CSoundBaseDevice::CSoundBaseDevice(unsigned nSampleRate, unsigned nChunkSize) :
+m_nSampleRate{nSampleRate},
+m_nChunkSize{nChunkSize},
+m_nChannels{2},
+m_bActive{},
+m_nQueueSizeFrames{},
+m_nReadFrame{},
+m_nQueuedFrames{},
+m_pCallback{},
+m_pCallbackParam{}
+{
+}
+
+CSoundBaseDevice::~CSoundBaseDevice()
+{
+	if (s_pHost == this)
+	{
+		s_pHost = nullptr;
+	}
+}
+
+bool CSoundBaseDevice::Start()
+{
+	m_bActive = true;
+	s_pHost = this;
+
+	return true;
+}
+
+void CSoundBaseDevice::Cancel()
+{
+	m_bActive = false;
+}
+
+bool CSoundBaseDevice::IsActive() const
+{
+	return m_bActive;
+}
+
+bool CSoundBaseDevice::AllocateQueue(unsigned nSizeMsecs)
+{
+	return AllocateQueueFrames(m_nSampleRate * nSizeMsecs / 1000);
+}
+
+bool CSoundBaseDevice::AllocateQueueFrames(unsigned nSizeFrames)
+{
+	std::lock_guard<std::mutex> Lock(m_QueueMutex);
+
+	m_nQueueSizeFrames = nSizeFrames;
+	m_Queue.assign(m_nQueueSizeFrames * m_nChannels, 0);
+	m_nReadFrame = 0;
+	m_nQueuedFrames = 0;
+
+	return nSizeFrames > 0;
+}
+
+void CSoundBaseDevice::SetWriteFormat(TSoundFormat Format, unsigned nChannels)
+{
+	assert(Format == SoundFormatSigned24_32);
+	assert(nChannels > 0);
+
+	std::lock_guard<std::mutex> Lock(m_QueueMutex);
+
+	m_nChannels = nChannels;
+	m_Queue.assign(m_nQueueSizeFrames * m_nChannels, 0);
+	m_nReadFrame = 0;
+	m_nQueuedFrames = 0;
+}
+
+int CSoundBaseDevice::Write(const void *pBuffer, size_t nCount)
+{
+	std::lock_guard<std::mutex> Lock(m_QueueMutex);
+
+	const int32_t *pSamples = static_cast<const int32_t *>(pBuffer);
+	size_t nFrames = std::min(nCount / (m_nChannels * sizeof(int32_t)), m_nQueueSizeFrames - m_nQueuedFrames);
+
+	for (size_t i = 0; i < nFrames; i++)
+	{
+		size_t nFrame = (m_nReadFrame + m_nQueuedFrames + i) % m_nQueueSizeFrames;
+		memcpy(&m_Queue[nFrame * m_nChannels], &pSamples[i * m_nChannels], m_nChannels * sizeof(int32_t));
+	}
+
+	m_nQueuedFrames += nFrames;
+
+	return static_cast<int>(nFrames * m_nChannels * sizeof(int32_t));
+}
+
+unsigned CSoundBaseDevice::GetQueueSizeFrames()
+{
+	return static_cast<unsigned>(m_nQueueSizeFrames);
+}
+
+unsigned CSoundBaseDevice::GetQueueFramesAvail()
+{
+	std::lock_guard<std::mutex> Lock(m_QueueMutex);
+
+	return static_cast<unsigned>(m_nQueuedFrames);
+}
+
+void CSoundBaseDevice::RegisterNeedDataCallback(TSoundDataCallback *pCallback, void *pParam)
+{
+	m_pCallback = pCallback;
+	m_pCallbackParam = pParam;
+}
+
+CSoundBaseDevice *CSoundBaseDevice::GetHost()
+{
+	return s_pHost;
+}
+
+unsigned CSoundBaseDevice::Transfer(int32_t *pBuffer)
+{
+	unsigned nChunkFrames = GetChunkFrames();
+	size_t nFrames;
+
+	{
+		std::lock_guard<std::mutex> Lock(m_QueueMutex);
+
+		nFrames = std::min<size_t>(nChunkFrames, m_nQueuedFrames);
+		for (size_t i = 0; i < nFrames; i++)
+		{
+			memcpy(&pBuffer[i * m_nChannels], &m_Queue[m_nReadFrame * m_nChannels], m_nChannels * sizeof(int32_t));
+			m_nReadFrame = (m_nReadFrame + 1) % m_nQueueSizeFrames;
+		}
+
+		m_nQueuedFrames -= nFrames;
+	}
+
+	memset(&pBuffer[nFrames * m_nChannels], 0, (nChunkFrames - nFrames) * m_nChannels * sizeof(int32_t));
+
+	if (m_pCallback)
+	{
+		(*m_pCallback)(m_pCallbackParam);
+	}
+
+	return static_cast<unsigned>(nFrames);
+}
@@ -0,0 +1,61 @@
+//
+// timer.cpp
+//
+// Host replacement of the Circle timer
+//
+#include <circle/timer.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<unsigned> s_nBaseTicks{0};
+static std::atomic<int64_t> s_nBaseMicros{-1}; // real time of s_nBaseTicks, -1 if stopped
+
+static int64_t GetRealMicros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+CTimer *CTimer::Get()
+{
+	static CTimer s_Timer;
+	return &s_Timer;
+}
+
+unsigned CTimer::GetClockTicks()
+{
+	unsigned nTicks = s_nBaseTicks.load(std::memory_order_acquire);
+	int64_t nBaseMicros = s_nBaseMicros.load(std::memory_order_acquire);
+
+	return nBaseMicros < 0 ? nTicks : nTicks + static_cast<unsigned>(GetRealMicros() - nBaseMicros);
+}
+
+void CTimer::SetClockTicks(unsigned nTicks, bool bRunning)
+{
+	s_nBaseTicks.store(nTicks, std::memory_order_release);
+	s_nBaseMicros.store(bRunning ? GetRealMicros() : -1, std::memory_order_release);
+}
+
+TKernelTimerHandle CTimer::StartKernelTimer(unsigned nDelay, TKernelTimerHandler *pHandler,
+					    void *pParam, void *pContext)
+{
+	static TKernelTimerHandle s_hNext = 0;
+	return ++s_hNext;
+}
+
+void CTimer::CancelKernelTimer(TKernelTimerHandle hTimer)
+{
+}
+
+void CTimer::SimpleMsDelay(unsigned nMilliSeconds)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(nMilliSeconds));
+}
+
+void CTimer::SimpleusDelay(unsigned nMicroSeconds)
+{
+	std::this_thread::sleep_for(std::chrono::microseconds(nMicroSeconds));
+}
@@ -0,0 +1,265 @@
+//
+// main.cpp
+//
+// Offline renderer and benchmark of DreamDexed on the host. The main thread
+// is core 0 of CMiniDexed and the DMA of the sound device: it sends the MIDI
+// events through the serial MIDI device, takes one chunk per DMA period from
+// the sound queue and writes it to a WAV file. Cores 1 to 3 are threads,
+// which run the audio path of the device as is.
+//
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <circle/gpiomanager.h>
+#include <circle/multicore.h>
+#include <circle/serial.h>
+#include <circle/sound/soundbasedevice.h>
+#include <circle/timer.h>
+#include <fatfs/ff.h>
+
+#include "config.h"
+#include "midifile.h"
+#include "minidexed.h"
+
+static void Usage(const char *pProgram)
+{
+	fprintf(stderr,
+		"Usage: %s [options] input.mid\n"
+		"  -d dir      root of the SD card, with minidexed.ini, performance.ini,\n"
+		"              performance/ and sysex/ (default .)\n"
+		"  -o file     WAV file to write (default out.wav)\n"
+		"  -l seconds  tail after the last event (default 2)\n"
+		"Set ProfileEnabled=1 in minidexed.ini for the profile of the stages,\n"
+		"which is saved to profile.csv on the SD card.\n",
+		pProgram);
+}
+
+// 24 bit PCM, as the sound device takes Q23 samples
+class CWAVFile
+{
+public:
+	CWAVFile() :
+	m_pFile{},
+	m_nChannels{},
+	m_nDataBytes{}
+	{
+	}
+
+	bool Create(const char *pFileName)
+	{
+		m_pFile = fopen(pFileName, "wb");
+		if (!m_pFile)
+		{
+			fprintf(stderr, "Cannot create %s\n", pFileName);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool WriteHeader(unsigned nSampleRate, unsigned nChannels)
+	{
+		m_nChannels = nChannels;
+
+		uint8_t Header[44] = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+				      'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0};
+		Put16(&Header[22], nChannels);
+		Put32(&Header[24], nSampleRate);
+		Put32(&Header[28], nSampleRate * nChannels * 3);
+		Put16(&Header[32], nChannels * 3);
+		Put16(&Header[34], 24);
+		memcpy(&Header[36], "data", 4);
+
+		return fwrite(Header, sizeof Header, 1, m_pFile) == 1;
+	}
+
+	bool Write(const int32_t *pSamples, unsigned nFrames)
+	{
+		std::vector<uint8_t> Buffer(nFrames * m_nChannels * 3);
+		for (unsigned i = 0; i < nFrames * m_nChannels; i++)
+		{
+			Buffer[i * 3 + 0] = static_cast<uint8_t>(pSamples[i]);
+			Buffer[i * 3 + 1] = static_cast<uint8_t>(pSamples[i] >> 8);
+			Buffer[i * 3 + 2] = static_cast<uint8_t>(pSamples[i] >> 16);
+		}
+
+		m_nDataBytes += Buffer.size();
+
+		return fwrite(Buffer.data(), Buffer.size(), 1, m_pFile) == 1;
+	}
+
+	bool Close()
+	{
+		uint8_t Size[4];
+		bool bOK = true;
+
+		Put32(Size, 36 + m_nDataBytes);
+		bOK &= fseek(m_pFile, 4, SEEK_SET) == 0 && fwrite(Size, 4, 1, m_pFile) == 1;
+		Put32(Size, m_nDataBytes);
+		bOK &= fseek(m_pFile, 40, SEEK_SET) == 0 && fwrite(Size, 4, 1, m_pFile) == 1;
+
+		return fclose(m_pFile) == 0 && bOK;
+	}
+
+private:
+	static void Put16(uint8_t *pBuffer, unsigned nValue)
+	{
+		pBuffer[0] = static_cast<uint8_t>(nValue);
+		pBuffer[1] = static_cast<uint8_t>(nValue >> 8);
+	}
+
+	static void Put32(uint8_t *pBuffer, unsigned nValue)
+	{
+		Put16(pBuffer, nValue);
+		Put16(pBuffer + 2, nValue >> 16);
+	}
+
+	FILE *m_pFile;
+	unsigned m_nChannels;
+	unsigned m_nDataBytes;
+};
+
+// The clock is set only, while cores 1 to 3 wait and the queue is filled
+// above the level, on which core 1 renders the next block.
+static void WaitForAudioCores(CSoundBaseDevice *pSoundDevice)
+{
+	unsigned nFillFrames = pSoundDevice->GetQueueSizeFrames() / 2;
+
+	while (pSoundDevice->GetQueueFramesAvail() <= nFillFrames ||
+	       CMultiCoreSupport::GetWaitingCores() < CORES - 1)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(10));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *pSDCardDir = ".";
+	const char *pWAVFileName = "out.wav";
+	int nTailSeconds = 2;
+
+	int nOption;
+	while ((nOption = getopt(argc, argv, "d:o:l:")) != -1)
+	{
+		switch (nOption)
+		{
+		case 'd': pSDCardDir = optarg; break;
+		case 'o': pWAVFileName = optarg; break;
+		case 'l': nTailSeconds = atoi(optarg); break;
+		default: Usage(argv[0]); return EXIT_FAILURE;
+		}
+	}
+
+	if (optind != argc - 1 || nTailSeconds < 0)
+	{
+		Usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// the paths of the command line are relative to the working directory
+	CMIDIFile MIDIFile;
+	CWAVFile WAVFile;
+	if (!MIDIFile.Load(argv[optind]) || !WAVFile.Create(pWAVFileName))
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (chdir(pSDCardDir) != 0)
+	{
+		fprintf(stderr, "Cannot change to %s\n", pSDCardDir);
+		return EXIT_FAILURE;
+	}
+
+	CTimer::SetClockTicks(0, true);
+
+	FATFS FileSystem;
+	CConfig Config(&FileSystem);
+	Config.Load();
+
+	CGPIOManager GPIOManager(nullptr);
+	CMiniDexed *pMiniDexed = new CMiniDexed(&Config, nullptr, &GPIOManager, nullptr, nullptr, &FileSystem);
+	if (!pMiniDexed->Initialize())
+	{
+		fprintf(stderr, "Cannot initialize DreamDexed\n");
+		return EXIT_FAILURE;
+	}
+
+	CSoundBaseDevice *pSoundDevice = CSoundBaseDevice::GetHost();
+	CSerialDevice *pSerial = CSerialDevice::GetHost();
+	if (!pSoundDevice || !pSerial)
+	{
+		fprintf(stderr, "No sound device or serial MIDI\n");
+		return EXIT_FAILURE;
+	}
+
+	unsigned nSampleRate = pSoundDevice->GetSampleRate();
+	unsigned nChannels = pSoundDevice->GetChannels();
+	unsigned nChunkFrames = pSoundDevice->GetChunkFrames();
+	std::vector<int32_t> Chunk(nChunkFrames * nChannels);
+
+	if (!WAVFile.WriteHeader(nSampleRate, nChannels))
+	{
+		return EXIT_FAILURE;
+	}
+
+	const std::vector<CMIDIFile::TEvent> &Events = MIDIFile.GetEvents();
+	uint64_t nEndMicros = (Events.empty() ? 0 : Events.back().nMicros) + nTailSeconds * 1000000ULL;
+
+	size_t nEvent = 0;
+	uint64_t nFrames = 0;
+
+	WaitForAudioCores(pSoundDevice);
+
+	uint64_t nMicros;
+	while ((nMicros = nFrames * 1000000 / nSampleRate) < nEndMicros)
+	{
+		// the events since the previous DMA period, at their time
+		for (; nEvent < Events.size() && Events[nEvent].nMicros < nMicros; nEvent++)
+		{
+			const CMIDIFile::TEvent &Event = Events[nEvent];
+			uint8_t Message[3] = {Event.uchStatus, Event.uchData1, Event.uchData2};
+			unsigned nLength = (Event.uchStatus & 0xE0) == 0xC0 ? 2 : 3;
+
+			CTimer::SetClockTicks(static_cast<unsigned>(Event.nMicros), false);
+			pSerial->Receive(Message, nLength);
+			pMiniDexed->Process(false);
+		}
+
+		CTimer::SetClockTicks(static_cast<unsigned>(nMicros), false);
+		pMiniDexed->Process(false);
+
+		// the DMA interrupt, core 1 renders the next blocks meanwhile
+		CTimer::SetClockTicks(static_cast<unsigned>(nMicros), true);
+		pSoundDevice->Transfer(Chunk.data());
+
+		if (!WAVFile.Write(Chunk.data(), nChunkFrames))
+		{
+			fprintf(stderr, "Cannot write %s\n", pWAVFileName);
+			return EXIT_FAILURE;
+		}
+
+		nFrames += nChunkFrames;
+
+		WaitForAudioCores(pSoundDevice);
+	}
+
+	if (!WAVFile.Close())
+	{
+		fprintf(stderr, "Cannot write %s\n", pWAVFileName);
+		return EXIT_FAILURE;
+	}
+
+	// a last dump of the profile, which is due every 10 seconds of the clock
+	CTimer::SetClockTicks(static_cast<unsigned>(nMicros) + 10 * CLOCKHZ, false);
+	pMiniDexed->Process(false);
+
+	// the cores never return from Run()
+	fflush(nullptr);
+	_exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,232 @@
+//
+// midifile.cpp
+//
+// Reader of Standard MIDI Files for the offline renderer
+//
+#include "midifile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <circle/logger.h>
+
+LOGMODULE("midifile");
+
+static uint32_t Get16(const uint8_t *pData)
+{
+	return pData[0] << 8 | pData[1];
+}
+
+static uint32_t Get32(const uint8_t *pData)
+{
+	return static_cast<uint32_t>(pData[0]) << 24 | pData[1] << 16 | pData[2] << 8 | pData[3];
+}
+
+bool CMIDIFile::Load(const char *pFileName)
+{
+	m_Events.clear();
+
+	FILE *pFile = fopen(pFileName, "rb");
+	if (!pFile)
+	{
+		LOGERR("Cannot open %s", pFileName);
+
+		return false;
+	}
+
+	std::vector<uint8_t> Data;
+	uint8_t Buffer[4096];
+	size_t nRead;
+	while ((nRead = fread(Buffer, 1, sizeof Buffer, pFile)) > 0)
+	{
+		Data.insert(Data.end(), Buffer, Buffer + nRead);
+	}
+	fclose(pFile);
+
+	if (Data.size() < 14 || memcmp(Data.data(), "MThd", 4) != 0)
+	{
+		LOGERR("%s: No MIDI file", pFileName);
+
+		return false;
+	}
+
+	unsigned nFormat = Get16(&Data[8]);
+	unsigned nTracks = Get16(&Data[10]);
+	unsigned nDivision = Get16(&Data[12]);
+	if (nFormat > 1 || nDivision == 0)
+	{
+		LOGERR("%s: Format %u is not supported", pFileName, nFormat);
+
+		return false;
+	}
+
+	std::vector<TTrackEvent> Events;
+
+	size_t nPos = 8 + static_cast<size_t>(Get32(&Data[4]));
+	for (unsigned nTrack = 0; nTrack < nTracks && nPos + 8 <= Data.size(); nTrack++)
+	{
+		bool bTrack = memcmp(&Data[nPos], "MTrk", 4) == 0;
+		size_t nSize = Get32(&Data[nPos + 4]);
+		nPos += 8;
+
+		if (nSize > Data.size() - nPos || (bTrack && !ReadTrack(&Data[nPos], nSize, &Events)))
+		{
+			LOGERR("%s: Track %u is invalid", pFileName, nTrack + 1);
+
+			return false;
+		}
+
+		nPos += nSize;
+	}
+
+	// the tempo changes of the first track go before the notes at the same tick
+	std::stable_sort(Events.begin(), Events.end(),
+			 [](const TTrackEvent &A, const TTrackEvent &B) { return A.nTick < B.nTick; });
+
+	// SMPTE time has a fixed rate, otherwise it follows the tempo
+	double fTickMicros;
+	bool bSMPTE = nDivision & 0x8000;
+	if (bSMPTE)
+	{
+		int nFramesPerSecond = -static_cast<int8_t>(nDivision >> 8);
+		fTickMicros = 1000000.0 / (nFramesPerSecond * (nDivision & 0xFF));
+	}
+	else
+	{
+		fTickMicros = 500000.0 / nDivision; // 120 BPM
+	}
+
+	double fMicros = 0.0;
+	uint64_t nTick = 0;
+	for (const TTrackEvent &Event : Events)
+	{
+		fMicros += (Event.nTick - nTick) * fTickMicros;
+		nTick = Event.nTick;
+
+		if (!Event.nTempo)
+		{
+			m_Events.push_back(Event.Event);
+			m_Events.back().nMicros = static_cast<uint64_t>(fMicros);
+		}
+		else if (!bSMPTE)
+		{
+			fTickMicros = static_cast<double>(Event.nTempo) / nDivision;
+		}
+	}
+
+	return true;
+}
+
+bool CMIDIFile::ReadTrack(const uint8_t *pData, size_t nSize, std::vector<TTrackEvent> *pEvents)
+{
+	const uint8_t *pEnd = pData + nSize;
+	uint64_t nTick = 0;
+	uint8_t uchRunningStatus = 0;
+
+	while (pData < pEnd)
+	{
+		uint32_t nDelta;
+		if (!ReadVarLen(&pData, pEnd, &nDelta) || pData >= pEnd)
+		{
+			return false;
+		}
+
+		nTick += nDelta;
+
+		uint8_t uchStatus = *pData;
+		if (uchStatus & 0x80)
+		{
+			pData++;
+		}
+		else if (uchRunningStatus)
+		{
+			uchStatus = uchRunningStatus;
+		}
+		else
+		{
+			return false;
+		}
+
+		if (uchStatus == 0xFF) // meta event
+		{
+			if (pData >= pEnd)
+			{
+				return false;
+			}
+
+			uint8_t uchType = *pData++;
+			uint32_t nLength;
+			if (!ReadVarLen(&pData, pEnd, &nLength) || nLength > static_cast<size_t>(pEnd - pData))
+			{
+				return false;
+			}
+
+			if (uchType == 0x2F) // end of track
+			{
+				break;
+			}
+
+			if (uchType == 0x51 && nLength == 3) // tempo
+			{
+				unsigned nTempo = pData[0] << 16 | pData[1] << 8 | pData[2];
+				if (nTempo)
+				{
+					pEvents->push_back({nTick, nTempo, {}});
+				}
+			}
+
+			pData += nLength;
+			uchRunningStatus = 0;
+		}
+		else if (uchStatus == 0xF0 || uchStatus == 0xF7) // SysEx is skipped
+		{
+			uint32_t nLength;
+			if (!ReadVarLen(&pData, pEnd, &nLength) || nLength > static_cast<size_t>(pEnd - pData))
+			{
+				return false;
+			}
+
+			pData += nLength;
+			uchRunningStatus = 0;
+		}
+		else if (uchStatus < 0xF0)
+		{
+			// program change and channel aftertouch have one data byte
+			int nDataBytes = (uchStatus & 0xE0) == 0xC0 ? 1 : 2;
+			if (pEnd - pData < nDataBytes)
+			{
+				return false;
+			}
+
+			pEvents->push_back({nTick, 0, {0, uchStatus, pData[0], static_cast<uint8_t>(nDataBytes == 2 ? pData[1] : 0)}});
+
+			pData += nDataBytes;
+			uchRunningStatus = uchStatus;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CMIDIFile::ReadVarLen(const uint8_t **ppData, const uint8_t *pEnd, uint32_t *pValue)
+{
+	uint32_t nValue = 0;
+	for (int i = 0; i < 4 && *ppData < pEnd; i++)
+	{
+		uint8_t uchByte = *(*ppData)++;
+		nValue = nValue << 7 | (uchByte & 0x7F);
+		if (!(uchByte & 0x80))
+		{
+			*pValue = nValue;
+
+			return true;
+		}
+	}
+
+	return false;
+}
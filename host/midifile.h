@@ -0,0 +1,41 @@
+//
+// midifile.h
+//
+// Reader of Standard MIDI Files for the offline renderer
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The tracks of a file of format 0 or 1 are merged into one list of the
+// channel messages, timed in microseconds by the tempo map.
+class CMIDIFile
+{
+public:
+	struct TEvent
+	{
+		uint64_t nMicros;
+		uint8_t uchStatus;
+		uint8_t uchData1;
+		uint8_t uchData2;
+	};
+
+	bool Load(const char *pFileName);
+
+	const std::vector<TEvent> &GetEvents() const { return m_Events; }
+
+private:
+	struct TTrackEvent
+	{
+		uint64_t nTick;
+		unsigned nTempo; // microseconds per quarter note, 0 for a channel message
+		TEvent Event;
+	};
+
+	static bool ReadTrack(const uint8_t *pData, size_t nSize, std::vector<TTrackEvent> *pEvents);
+	static bool ReadVarLen(const uint8_t **ppData, const uint8_t *pEnd, uint32_t *pValue);
+
+	std::vector<TEvent> m_Events;
+};
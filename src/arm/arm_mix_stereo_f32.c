@@ -0,0 +1,79 @@
+#include "arm_mix_stereo_f32.h"
+
+/**
+  Scale a vector with two scalars and add it to two vectors, in one pass.
+  For floating-point data, the algorithm used is:
+
+  <pre>
+      pDstL[n] += pSrc[n] * scaleL, pDstR[n] += pSrc[n] * scaleR   0 <= n < blockSize.
+  </pre>
+
+ */
+
+/**
+ * @brief Scale a floating-point vector with two scalars and add it to two vectors.
+ * @param[in]     pSrc       points to the input vector
+ * @param[in]     scaleL     scale scalar of the left output
+ * @param[in]     scaleR     scale scalar of the right output
+ * @param[in,out] pDstL      points to the left output vector
+ * @param[in,out] pDstR      points to the right output vector
+ * @param[in]     blockSize  number of samples in the vector
+ */
+
+#if defined(ARM_MATH_NEON_EXPERIMENTAL)
+#include <arm_math.h>
+
+void arm_mix_stereo_f32(const float *pSrc, float scaleL, float scaleR, float *pDstL, float *pDstR, int blockSize)
+{
+	int blkCnt; /* Loop counter */
+
+	f32x4_t in;
+
+	/* Compute 4 outputs at a time */
+	blkCnt = blockSize >> 2;
+
+	while (blkCnt > 0)
+	{
+		in = vld1q_f32(pSrc);
+		vst1q_f32(pDstL, vmlaq_n_f32(vld1q_f32(pDstL), in, scaleL));
+		vst1q_f32(pDstR, vmlaq_n_f32(vld1q_f32(pDstR), in, scaleR));
+
+		/* Increment pointers */
+		pSrc += 4;
+		pDstL += 4;
+		pDstR += 4;
+
+		/* Decrement the loop counter */
+		blkCnt--;
+	}
+
+	/* If the blockSize is not a multiple of 4, compute any remaining output samples here.
+	** No loop unrolling is used. */
+	blkCnt = blockSize & 3;
+
+	while (blkCnt > 0)
+	{
+		*pDstL++ += *pSrc * scaleL;
+		*pDstR++ += *pSrc++ * scaleR;
+
+		/* Decrement the loop counter */
+		blkCnt--;
+	}
+}
+#else
+void arm_mix_stereo_f32(const float *pSrc, float scaleL, float scaleR, float *pDstL, float *pDstR, int blockSize)
+{
+	int blkCnt; /* Loop counter */
+
+	blkCnt = blockSize;
+
+	while (blkCnt > 0)
+	{
+		*pDstL++ += *pSrc * scaleL;
+		*pDstR++ += *pSrc++ * scaleR;
+
+		/* Decrement the loop counter */
+		blkCnt--;
+	}
+}
+#endif
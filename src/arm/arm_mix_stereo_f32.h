@@ -0,0 +1,21 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Scale a floating-point vector with two scalars and add it to two vectors.
+ * @param[in]     pSrc       points to the input vector
+ * @param[in]     scaleL     scale scalar of the left output
+ * @param[in]     scaleR     scale scalar of the right output
+ * @param[in,out] pDstL      points to the left output vector
+ * @param[in,out] pDstR      points to the right output vector
+ * @param[in]     blockSize  number of samples in the vector
+ */
+void arm_mix_stereo_f32(const float *pSrc, float scaleL, float scaleR, float *pDstL, float *pDstR, int blockSize);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+#include "arm_mix_stereo_ramp_f32.h"
+
+#include "arm_mix_stereo_f32.h"
+#include "arm_scale_ramp_f32.h"
+
+/**
+  Scale a vector with two scalars, which are ramped to their targets, and add it to two vectors.
+  For floating-point data, the algorithm used is:
+
+  <pre>
+      pDstL[n] += pSrc[n] * clamp(scaleL + (n + 1) * stepL, scaleL, targetL)
+      pDstR[n] += pSrc[n] * clamp(scaleR + (n + 1) * stepR, scaleR, targetR)   0 <= n < blockSize.
+  </pre>
+
+  Only the longer of both ramps is computed per sample,
+  the remaining samples are added with the targets by arm_mix_stereo_f32().
+
+ */
+
+/**
+ * @brief Scale a floating-point vector with two scalars, which are ramped to their targets, and add it to two vectors.
+ * @param[in]     pSrc       points to the input vector
+ * @param[in,out] pScale     points to the left and right scale scalars, updated to the values after the block
+ * @param[in]     pTarget    points to the left and right targets of the ramps
+ * @param[in]     ramp       change of the scales per sample
+ * @param[in,out] pDstL      points to the left output vector
+ * @param[in,out] pDstR      points to the right output vector
+ * @param[in]     blockSize  number of samples in the vector
+ */
+
+#if defined(ARM_MATH_NEON_EXPERIMENTAL)
+#include <arm_math.h>
+#endif
+
+void arm_mix_stereo_ramp_f32(const float *pSrc, float *pScale, const float *pTarget, float ramp, float *pDstL, float *pDstR, int blockSize)
+{
+	int rampCntL = arm_ramp_length_f32(pScale[0], pTarget[0], ramp, blockSize);
+	int rampCntR = arm_ramp_length_f32(pScale[1], pTarget[1], ramp, blockSize);
+	int rampCnt = rampCntL > rampCntR ? rampCntL : rampCntR;
+
+	float stepL = pTarget[0] > pScale[0] ? ramp : -ramp;
+	float stepR = pTarget[1] > pScale[1] ? ramp : -ramp;
+	float loL = fminf(pScale[0], pTarget[0]);
+	float hiL = fmaxf(pScale[0], pTarget[0]);
+	float loR = fminf(pScale[1], pTarget[1]);
+	float hiR = fmaxf(pScale[1], pTarget[1]);
+
+	int i = 0;
+
+#if defined(ARM_MATH_NEON_EXPERIMENTAL)
+	const float index[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+	f32x4_t vIndex = vld1q_f32(index);
+	f32x4_t vScaleL, vScaleR, in;
+
+	/* Compute 4 ramped outputs at a time */
+	for (; i + 4 <= rampCnt; i += 4)
+	{
+		vScaleL = vmlaq_n_f32(vdupq_n_f32(pScale[0]), vIndex, stepL);
+		vScaleL = vminq_f32(vmaxq_f32(vScaleL, vdupq_n_f32(loL)), vdupq_n_f32(hiL));
+		vScaleR = vmlaq_n_f32(vdupq_n_f32(pScale[1]), vIndex, stepR);
+		vScaleR = vminq_f32(vmaxq_f32(vScaleR, vdupq_n_f32(loR)), vdupq_n_f32(hiR));
+
+		in = vld1q_f32(pSrc + i);
+		vst1q_f32(pDstL + i, vmlaq_f32(vld1q_f32(pDstL + i), in, vScaleL));
+		vst1q_f32(pDstR + i, vmlaq_f32(vld1q_f32(pDstR + i), in, vScaleR));
+
+		vIndex = vaddq_f32(vIndex, vdupq_n_f32(4.0f));
+	}
+#endif
+
+	/* Compute the remaining ramped outputs */
+	for (; i < rampCnt; ++i)
+	{
+		pDstL[i] += pSrc[i] * fminf(fmaxf(pScale[0] + (i + 1) * stepL, loL), hiL);
+		pDstR[i] += pSrc[i] * fminf(fmaxf(pScale[1] + (i + 1) * stepR, loR), hiR);
+	}
+
+	pScale[0] = fminf(fmaxf(pScale[0] + rampCnt * stepL, loL), hiL);
+	pScale[1] = fminf(fmaxf(pScale[1] + rampCnt * stepR, loR), hiR);
+
+	arm_mix_stereo_f32(pSrc + rampCnt, pScale[0], pScale[1], pDstL + rampCnt, pDstR + rampCnt, blockSize - rampCnt);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Scale a floating-point vector with two scalars, which are ramped to their targets, and add it to two vectors.
+ * @param[in]     pSrc       points to the input vector
+ * @param[in,out] pScale     points to the left and right scale scalars, updated to the values after the block
+ * @param[in]     pTarget    points to the left and right targets of the ramps
+ * @param[in]     ramp       change of the scales per sample
+ * @param[in,out] pDstL      points to the left output vector
+ * @param[in,out] pDstR      points to the right output vector
+ * @param[in]     blockSize  number of samples in the vector
+ */
+void arm_mix_stereo_ramp_f32(const float *pSrc, float *pScale, const float *pTarget, float ramp, float *pDstL, float *pDstR, int blockSize);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,76 @@
+#include "arm_scale_interleave_q23.h"
+
+#include <arm_math.h>
+
+/**
+  Scale vectors with a scalar, interleave and convert them to Q23 in one pass.
+  For floating-point data, the algorithm used is:
+
+  <pre>
+      pDst[nChannels * n + c] = sat23(pSrc[c][n] * scale * 8388608)   0 <= n < blockSize, 0 <= c < nChannels.
+  </pre>
+
+ */
+
+/**
+ * @brief Scale floating-point vectors with a scalar, interleave them and convert to Q23.
+ * @param[in]  pSrc       points to the nChannels input vectors, a NULL vector is silence
+ * @param[in]  nChannels  number of input vectors
+ * @param[in]  scale      scale scalar
+ * @param[out] pDst       points to the Q23 output vector, nChannels * blockSize samples
+ * @param[in]  blockSize  number of samples in each input vector
+ */
+
+void arm_scale_interleave_q23(const float *const *pSrc, int nChannels, float scale, q23_t *pDst, int blockSize)
+{
+	int i = 0;
+
+#if defined(ARM_MATH_NEON_EXPERIMENTAL)
+	if ((nChannels & 3) == 0)
+	{
+		int32x4_t v[4];
+		int32x4x2_t t0, t1;
+
+		/* Compute 4 frames at a time, transposing 4 channels by 4 frames */
+		for (; i + 4 <= blockSize; i += 4)
+		{
+			for (int c = 0; c < nChannels; c += 4)
+			{
+				for (int k = 0; k < 4; ++k)
+				{
+					if (pSrc[c + k])
+					{
+						v[k] = vcvtq_n_s32_f32(vmulq_n_f32(vld1q_f32(pSrc[c + k] + i), scale), 23);
+
+						/* saturate */
+						v[k] = vminq_s32(v[k], vdupq_n_s32(0x007fffff));
+						v[k] = vmaxq_s32(v[k], vdupq_n_s32(0xff800000));
+					}
+					else
+					{
+						v[k] = vdupq_n_s32(0);
+					}
+				}
+
+				t0 = vtrnq_s32(v[0], v[1]);
+				t1 = vtrnq_s32(v[2], v[3]);
+
+				q23_t *pOut = pDst + i * nChannels + c;
+				vst1q_s32(pOut, vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0])));
+				vst1q_s32(pOut + nChannels, vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1])));
+				vst1q_s32(pOut + 2 * nChannels, vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0])));
+				vst1q_s32(pOut + 3 * nChannels, vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1])));
+			}
+		}
+	}
+#endif
+
+	/* Compute the remaining frames */
+	for (; i < blockSize; ++i)
+	{
+		for (int c = 0; c < nChannels; ++c)
+		{
+			pDst[i * nChannels + c] = pSrc[c] ? (q23_t)__SSAT((q31_t)(pSrc[c][i] * scale * 8388608.0f), 24) : 0;
+		}
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "arm_float_to_q23.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Scale floating-point vectors with a scalar, interleave them and convert to Q23.
+ * @param[in]  pSrc       points to the nChannels input vectors, a NULL vector is silence
+ * @param[in]  nChannels  number of input vectors
+ * @param[in]  scale      scale scalar
+ * @param[out] pDst       points to the Q23 output vector, nChannels * blockSize samples
+ * @param[in]  blockSize  number of samples in each input vector
+ */
+void arm_scale_interleave_q23(const float *const *pSrc, int nChannels, float scale, q23_t *pDst, int blockSize);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,128 @@
+#include "arm_scale_ramp_f32.h"
+
+/**
+  Scale a vector with a scalar, which is ramped to a target.
+  For floating-point data, the algorithm used is:
+
+  <pre>
+      pDst[n] = pSrc[n] * clamp(scale + (n + 1) * step, scale, target)   0 <= n < blockSize.
+  </pre>
+
+  The length of the ramp is computed first, only the ramp is computed per sample,
+  the remaining samples are scaled with the target.
+
+ */
+
+/**
+ * @brief Scale a floating-point vector with a scalar, which is ramped to a target.
+ * @param[in]  pSrc       points to the input vector
+ * @param[in]  scale      scale scalar at the start
+ * @param[in]  target     scale scalar at the end of the ramp
+ * @param[in]  ramp       change of the scale per sample
+ * @param[out] pDst       points to the output vector
+ * @param[in]  blockSize  number of samples in the vector
+ * @return     scale scalar after the block
+ */
+
+#if defined(ARM_MATH_NEON_EXPERIMENTAL)
+#include <arm_math.h>
+
+float arm_scale_ramp_f32(const float *pSrc, float scale, float target, float ramp, float *pDst, int blockSize)
+{
+	int blkCnt; /* Loop counter */
+	int rampCnt = arm_ramp_length_f32(scale, target, ramp, blockSize);
+
+	float step = target > scale ? ramp : -ramp;
+	float lo = fminf(scale, target);
+	float hi = fmaxf(scale, target);
+
+	const float index[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+	f32x4_t vIndex = vld1q_f32(index);
+	f32x4_t vScale;
+
+	/* Compute 4 ramped outputs at a time */
+	blkCnt = rampCnt >> 2;
+
+	while (blkCnt > 0)
+	{
+		vScale = vmlaq_n_f32(vdupq_n_f32(scale), vIndex, step);
+		vScale = vminq_f32(vmaxq_f32(vScale, vdupq_n_f32(lo)), vdupq_n_f32(hi));
+		vst1q_f32(pDst, vmulq_f32(vld1q_f32(pSrc), vScale));
+
+		vIndex = vaddq_f32(vIndex, vdupq_n_f32(4.0f));
+
+		/* Increment pointers */
+		pSrc += 4;
+		pDst += 4;
+
+		/* Decrement the loop counter */
+		blkCnt--;
+	}
+
+	/* Compute the remaining 1 to 3 ramped outputs */
+	for (int i = rampCnt & ~3; i < rampCnt; ++i)
+	{
+		*pDst++ = *pSrc++ * fminf(fmaxf(scale + (i + 1) * step, lo), hi);
+	}
+
+	scale = fminf(fmaxf(scale + rampCnt * step, lo), hi);
+
+	/* Compute 4 outputs with the target at a time */
+	blkCnt = (blockSize - rampCnt) >> 2;
+
+	while (blkCnt > 0)
+	{
+		vst1q_f32(pDst, vmulq_n_f32(vld1q_f32(pSrc), scale));
+
+		/* Increment pointers */
+		pSrc += 4;
+		pDst += 4;
+
+		/* Decrement the loop counter */
+		blkCnt--;
+	}
+
+	/* If the remaining size is not a multiple of 4, compute any remaining output samples here.
+	** No loop unrolling is used. */
+	blkCnt = (blockSize - rampCnt) & 3;
+
+	while (blkCnt > 0)
+	{
+		*pDst++ = *pSrc++ * scale;
+
+		/* Decrement the loop counter */
+		blkCnt--;
+	}
+
+	return scale;
+}
+#else
+float arm_scale_ramp_f32(const float *pSrc, float scale, float target, float ramp, float *pDst, int blockSize)
+{
+	int blkCnt; /* Loop counter */
+	int rampCnt = arm_ramp_length_f32(scale, target, ramp, blockSize);
+
+	float step = target > scale ? ramp : -ramp;
+	float lo = fminf(scale, target);
+	float hi = fmaxf(scale, target);
+
+	for (int i = 0; i < rampCnt; ++i)
+	{
+		*pDst++ = *pSrc++ * fminf(fmaxf(scale + (i + 1) * step, lo), hi);
+	}
+
+	scale = fminf(fmaxf(scale + rampCnt * step, lo), hi);
+
+	blkCnt = blockSize - rampCnt;
+
+	while (blkCnt > 0)
+	{
+		*pDst++ = *pSrc++ * scale;
+
+		/* Decrement the loop counter */
+		blkCnt--;
+	}
+
+	return scale;
+}
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Number of samples until a ramp reaches its target, at most blockSize.
+ * @param[in]  scale      start value
+ * @param[in]  target     end value
+ * @param[in]  ramp       change per sample, must be > 0
+ * @param[in]  blockSize  number of samples in the vector
+ */
+static inline int arm_ramp_length_f32(float scale, float target, float ramp, int blockSize)
+{
+	float steps = ceilf(fabsf(target - scale) / ramp);
+
+	return steps < (float)blockSize ? (int)steps : blockSize;
+}
+
+/**
+ * @brief Scale a floating-point vector with a scalar, which is ramped to a target.
+ * @param[in]  pSrc       points to the input vector
+ * @param[in]  scale      scale scalar at the start
+ * @param[in]  target     scale scalar at the end of the ramp
+ * @param[in]  ramp       change of the scale per sample
+ * @param[out] pDst       points to the output vector
+ * @param[in]  blockSize  number of samples in the vector
+ * @return     scale scalar after the block
+ */
+float arm_scale_ramp_f32(const float *pSrc, float scale, float target, float ramp, float *pDst, int blockSize);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,84 @@
+#include "arm_scale_ramp_zip_q23.h"
+
+#include <math.h>
+
+#include <arm_math.h>
+
+/**
+  Scale two vectors with scalars, which are ramped to a target, zip and convert them to Q23 in one pass.
+  For floating-point data, the algorithm used is:
+
+  <pre>
+      pDst[2n] = sat23(pSrc1[n] * clamp(scale1 + (n + 1) * step1, scale1, target) * 8388608),
+      pDst[2n+1] = sat23(pSrc2[n] * clamp(scale2 + (n + 1) * step2, scale2, target) * 8388608)   0 <= n < blockSize.
+  </pre>
+
+  When a scale is at the target already, its step is 0 and it is a plain scale.
+
+ */
+
+/**
+ * @brief Scale two floating-point vectors with scalars, which are ramped to a target, zip them and convert to Q23.
+ * @param[in]     pSrc1      points to the input vector 1
+ * @param[in]     pSrc2      points to the input vector 2
+ * @param[in,out] pScale1    points to the scale scalar of vector 1, updated to the value after the block
+ * @param[in,out] pScale2    points to the scale scalar of vector 2, updated to the value after the block
+ * @param[in]     target     target of the scales
+ * @param[in]     ramp       change of the scales per sample
+ * @param[out]    pDst       points to the Q23 output vector, 2 * blockSize samples
+ * @param[in]     blockSize  number of samples in each input vector
+ */
+
+void arm_scale_ramp_zip_q23(const float *pSrc1, const float *pSrc2, float *pScale1, float *pScale2, float target, float ramp, q23_t *pDst, int blockSize)
+{
+	float scale1 = *pScale1;
+	float scale2 = *pScale2;
+	float step1 = target > scale1 ? ramp : target < scale1 ? -ramp : 0.0f;
+	float step2 = target > scale2 ? ramp : target < scale2 ? -ramp : 0.0f;
+	float lo1 = fminf(scale1, target);
+	float hi1 = fmaxf(scale1, target);
+	float lo2 = fminf(scale2, target);
+	float hi2 = fmaxf(scale2, target);
+
+	int i = 0;
+
+#if defined(ARM_MATH_NEON_EXPERIMENTAL)
+	const float index[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+	f32x4_t vIndex = vld1q_f32(index);
+	f32x4_t vScale1, vScale2;
+	int32x4x2_t res;
+
+	/* Compute 4 output pairs at a time */
+	for (; i + 4 <= blockSize; i += 4)
+	{
+		vScale1 = vmlaq_n_f32(vdupq_n_f32(scale1), vIndex, step1);
+		vScale1 = vminq_f32(vmaxq_f32(vScale1, vdupq_n_f32(lo1)), vdupq_n_f32(hi1));
+		vScale2 = vmlaq_n_f32(vdupq_n_f32(scale2), vIndex, step2);
+		vScale2 = vminq_f32(vmaxq_f32(vScale2, vdupq_n_f32(lo2)), vdupq_n_f32(hi2));
+
+		res.val[0] = vcvtq_n_s32_f32(vmulq_f32(vld1q_f32(pSrc1 + i), vScale1), 23);
+		res.val[1] = vcvtq_n_s32_f32(vmulq_f32(vld1q_f32(pSrc2 + i), vScale2), 23);
+
+		/* saturate */
+		res.val[0] = vmaxq_s32(vminq_s32(res.val[0], vdupq_n_s32(0x007fffff)), vdupq_n_s32(0xff800000));
+		res.val[1] = vmaxq_s32(vminq_s32(res.val[1], vdupq_n_s32(0x007fffff)), vdupq_n_s32(0xff800000));
+
+		vst2q_s32(pDst + 2 * i, res);
+
+		vIndex = vaddq_f32(vIndex, vdupq_n_f32(4.0f));
+	}
+#endif
+
+	/* Compute the remaining output pairs */
+	for (; i < blockSize; ++i)
+	{
+		float s1 = fminf(fmaxf(scale1 + (i + 1) * step1, lo1), hi1);
+		float s2 = fminf(fmaxf(scale2 + (i + 1) * step2, lo2), hi2);
+
+		pDst[2 * i] = (q23_t)__SSAT((q31_t)(pSrc1[i] * s1 * 8388608.0f), 24);
+		pDst[2 * i + 1] = (q23_t)__SSAT((q31_t)(pSrc2[i] * s2 * 8388608.0f), 24);
+	}
+
+	*pScale1 = fminf(fmaxf(scale1 + blockSize * step1, lo1), hi1);
+	*pScale2 = fminf(fmaxf(scale2 + blockSize * step2, lo2), hi2);
+}
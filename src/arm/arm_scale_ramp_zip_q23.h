@@ -0,0 +1,25 @@
+#pragma once
+
+#include "arm_float_to_q23.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Scale two floating-point vectors with scalars, which are ramped to a target, zip them and convert to Q23.
+ * @param[in]     pSrc1      points to the input vector 1
+ * @param[in]     pSrc2      points to the input vector 2
+ * @param[in,out] pScale1    points to the scale scalar of vector 1, updated to the value after the block
+ * @param[in,out] pScale2    points to the scale scalar of vector 2, updated to the value after the block
+ * @param[in]     target     target of the scales
+ * @param[in]     ramp       change of the scales per sample
+ * @param[out]    pDst       points to the Q23 output vector, 2 * blockSize samples
+ * @param[in]     blockSize  number of samples in each input vector
+ */
+void arm_scale_ramp_zip_q23(const float *pSrc1, const float *pSrc2, float *pScale1, float *pScale2, float target, float ramp, q23_t *pDst, int blockSize);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+//
+// audioarena.h
+//
+// MiniDexed - Dexed FM synthesizer for bare metal Raspberry Pi
+// Copyright (C) 2022  The MiniDexed Team
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// One block of memory for the audio buffers, which is allocated at init.
+// The buffers are reserved first, then taken in the same order. Each buffer
+// starts on its own cache line, so that buffers written by different cores
+// do not share a cache line.
+
+class CAudioArena
+{
+public:
+	static constexpr size_t CacheLine = 64;
+
+	CAudioArena() :
+	m_pMemory{},
+	m_pBase{},
+	m_nSize{},
+	m_nUsed{}
+	{
+	}
+
+	~CAudioArena()
+	{
+		delete[] m_pMemory;
+	}
+
+	template <typename T>
+	void Reserve(size_t nCount, size_t nBuffers = 1)
+	{
+		assert(!m_pBase);
+		m_nSize += GetBytes<T>(nCount) * nBuffers;
+	}
+
+	void Allocate()
+	{
+		assert(!m_pBase);
+		m_pMemory = new uint8_t[m_nSize + CacheLine - 1];
+		m_pBase = reinterpret_cast<uint8_t *>((reinterpret_cast<uintptr_t>(m_pMemory) + CacheLine - 1) & ~(CacheLine - 1));
+	}
+
+	// returns a zeroed buffer
+	template <typename T>
+	T *Take(size_t nCount)
+	{
+		size_t nBytes = GetBytes<T>(nCount);
+
+		assert(m_pBase);
+		assert(m_nUsed + nBytes <= m_nSize);
+
+		T *pBuffer = reinterpret_cast<T *>(m_pBase + m_nUsed);
+		memset(pBuffer, 0, nBytes);
+		m_nUsed += nBytes;
+
+		return pBuffer;
+	}
+
+	size_t GetSize() const
+	{
+		return m_nSize;
+	}
+
+private:
+	template <typename T>
+	static size_t GetBytes(size_t nCount)
+	{
+		return (nCount * sizeof(T) + CacheLine - 1) & ~(CacheLine - 1);
+	}
+
+	uint8_t *m_pMemory;
+	uint8_t *m_pBase;
+	size_t m_nSize;
+	size_t m_nUsed;
+};
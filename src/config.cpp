@@ -67,6 +67,9 @@ void CConfig::Load()
 
 	m_nSampleRate = m_Properties.GetNumber("SampleRate", 48000);
 	m_bQuadDAC8Chan = m_Properties.GetNumber("QuadDAC8Chan", 0) != 0;
+	m_bQuadDAC8ChanBuses = m_Properties.GetNumber("QuadDAC8ChanBuses", 0) != 0;
+	m_bAudioPipeline = m_Properties.GetNumber("AudioPipeline", 0) != 0;
+	m_bLoadGovernor = m_Properties.GetNumber("LoadGovernor", 0) != 0;
 	if (m_SoundDevice == "hdmi")
 	{
 		m_nChunkSize = m_Properties.GetNumber("ChunkSize", 384 * 6);
@@ -79,6 +82,24 @@ void CConfig::Load()
 		m_nChunkSize = m_Properties.GetNumber("ChunkSize", 1024);
 #endif
 	}
+	// frames per audio block, a smaller power of two lowers the latency (multi core only)
+	unsigned nChunkFrames = m_nChunkSize;
+#ifdef ARM_ALLOW_MULTI_CORE
+	nChunkFrames /= m_bQuadDAC8Chan ? 8 : 2;
+	m_nRenderQuantum = m_Properties.GetNumber("RenderQuantum", 0);
+	if (m_nRenderQuantum < MinRenderQuantum || m_nRenderQuantum > nChunkFrames || m_nRenderQuantum % MinRenderQuantum || (m_nRenderQuantum & (m_nRenderQuantum - 1)))
+	{
+		m_nRenderQuantum = nChunkFrames;
+	}
+#else
+	m_nRenderQuantum = nChunkFrames;
+#endif
+	// whole Dexed steps only, the TG output buffers are one block long
+	m_nRenderQuantum -= m_nRenderQuantum % MinRenderQuantum;
+	if (m_nRenderQuantum < MinRenderQuantum)
+	{
+		m_nRenderQuantum = MinRenderQuantum;
+	}
 	m_nDACI2CAddress = static_cast<uint8_t>(m_Properties.GetNumber("DACI2CAddress", 0));
 	m_bChannelsSwapped = m_Properties.GetNumber("ChannelsSwapped", 0) != 0;
 
@@ -304,38 +325,6 @@ int CConfig::GetPolyphony() const
 	return m_nPolyphony;
 }
 
-int CConfig::GetTGsCore1() const
-{
-#ifndef ARM_ALLOW_MULTI_CORE
-	return 0;
-#else
-	if (m_nToneGenerators > MinToneGenerators)
-	{
-		return TGsCore1 + TGsCore1Opt;
-	}
-	else
-	{
-		return TGsCore1;
-	}
-#endif
-}
-
-int CConfig::GetTGsCore23() const
-{
-#ifndef ARM_ALLOW_MULTI_CORE
-	return 0;
-#else
-	if (m_nToneGenerators > MinToneGenerators)
-	{
-		return TGsCore23 + TGsCore23Opt;
-	}
-	else
-	{
-		return TGsCore23;
-	}
-#endif
-}
-
 bool CConfig::GetUSBGadget() const
 {
 	return m_bUSBGadget;
@@ -371,6 +360,11 @@ unsigned CConfig::GetChunkSize() const
 	return m_nChunkSize;
 }
 
+unsigned CConfig::GetRenderQuantum() const
+{
+	return m_nRenderQuantum;
+}
+
 uint8_t CConfig::GetDACI2CAddress() const
 {
 	return m_nDACI2CAddress;
@@ -391,6 +385,21 @@ bool CConfig::GetQuadDAC8Chan() const
 	return m_bQuadDAC8Chan;
 }
 
+bool CConfig::GetQuadDAC8ChanBuses() const
+{
+	return m_bQuadDAC8ChanBuses;
+}
+
+bool CConfig::GetAudioPipeline() const
+{
+	return m_bAudioPipeline;
+}
+
+bool CConfig::GetLoadGovernor() const
+{
+	return m_bLoadGovernor;
+}
+
 unsigned CConfig::GetMIDIBaudRate() const
 {
 	return m_nMIDIBaudRate;
@@ -47,15 +47,16 @@ public:
 	static constexpr int Buses = 0;
 	static constexpr int BusFXChains = 0;
 #else
-	static constexpr int TGsCore1 = 2; // process 2 TGs on core 1
-	static constexpr int TGsCore23 = 3; // process 3 TGs on core 2 and 3 each
+	// TGs are rendered by cores 1-3 as shared jobs, these only size the TG count
+	static constexpr int TGsCore1 = 2; // 2 TGs for core 1
+	static constexpr int TGsCore23 = 3; // 3 TGs for core 2 and 3 each
 #if (RASPPI == 4)
-	static constexpr int TGsCore1Opt = 4; // process optional additional 4 TGs on core 1
-	static constexpr int TGsCore23Opt = 6; // process optional additional 6 TGs on core 2 and 3 each
+	static constexpr int TGsCore1Opt = 4; // optional additional 4 TGs for core 1
+	static constexpr int TGsCore23Opt = 6; // optional additional 6 TGs for core 2 and 3 each
 	static constexpr int Buses = 3;
 #elif (RASPPI == 5)
-	static constexpr int TGsCore1Opt = 6; // process optional additional 6 TGs on core 1
-	static constexpr int TGsCore23Opt = 9; // process optional additional 9 TGs on core 2 and 3 each
+	static constexpr int TGsCore1Opt = 6; // optional additional 6 TGs for core 1
+	static constexpr int TGsCore23Opt = 9; // optional additional 9 TGs for core 2 and 3 each
 	static constexpr int Buses = 4;
 #else // Pi 2 or 3 quad core
 	static constexpr int TGsCore1Opt = 0;
@@ -89,6 +90,7 @@ public:
 #endif
 
 	static constexpr int MaxChunkSize = 4096;
+	static constexpr unsigned MinRenderQuantum = 64; // Dexed renders in steps of _N_ frames
 
 #if RASPPI <= 3
 	static constexpr int MaxUSBMIDIDevices = 2;
@@ -108,8 +110,6 @@ public:
 	// TGs and Polyphony
 	int GetToneGenerators() const;
 	int GetPolyphony() const;
-	int GetTGsCore1() const;
-	int GetTGsCore23() const;
 
 	// USB Mode
 	bool GetUSBGadget() const;
@@ -121,10 +121,14 @@ public:
 	const char *GetSoundDevice() const;
 	unsigned GetSampleRate() const;
 	unsigned GetChunkSize() const;
+	unsigned GetRenderQuantum() const; // frames per audio block, one chunk if not specified
 	uint8_t GetDACI2CAddress() const; // 0 for auto probing
 	bool GetChannelsSwapped() const;
 	uint8_t GetEngineType() const;
 	bool GetQuadDAC8Chan() const; // false if not specified
+	bool GetQuadDAC8ChanBuses() const; // false if not specified
+	bool GetAudioPipeline() const; // false if not specified
+	bool GetLoadGovernor() const; // false if not specified
 
 	// MIDI
 	unsigned GetMIDIBaudRate() const;
@@ -301,10 +305,14 @@ private:
 	std::string m_SoundDevice;
 	unsigned m_nSampleRate;
 	unsigned m_nChunkSize;
+	unsigned m_nRenderQuantum;
 	uint8_t m_nDACI2CAddress;
 	bool m_bChannelsSwapped;
 	uint8_t m_EngineType;
 	bool m_bQuadDAC8Chan;
+	bool m_bQuadDAC8ChanBuses;
+	bool m_bAudioPipeline;
+	bool m_bLoadGovernor;
 
 	unsigned m_nMIDIBaudRate;
 	std::string m_MIDIThruIn;
@@ -20,19 +20,31 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 
-#include <circle/spinlock.h>
+#include <circle/synchronize.h>
+#include <circle/sysconfig.h>
+#include <circle/timer.h>
 #include <compressor.h>
 #include <dexed.h>
 #include <synth_dexed.h>
 
 #include "effect_3bandeqmono.h"
+#include "spscqueue.h"
 
 #define DEXED_OP_ENABLE (DEXED_OP_OSC_DETUNE + 1)
 
-// Some Dexed methods require to be guarded from being interrupted
-// by other Dexed calls. This is done herein.
+// Dexed methods, which modify the state used for rendering, are called
+// on core 0 but must not run concurrently to getSamples() on the render
+// core. They are passed as commands herein, which are applied by
+// getSamples() at the start of or inside the next block.
+// Core 0 is the only producer, IRQs are disabled while a command is
+// queued, because MIDI may also arrive from IRQ context.
 
 class CDexedAdapter : public Dexed
 {
@@ -41,78 +53,593 @@ public:
 	Dexed{static_cast<uint8_t>(maxnotes), samplerate},
 	EQ{static_cast<float>(samplerate)},
 	Compr{static_cast<float>(samplerate)},
-	m_bCompressorEnable{}
+	m_bCompressorEnable{},
+	m_nActiveVoices{},
+	m_nVoiceLimit{},
+	m_nBlockVoiceLimit{},
+	m_nFadingVoices{},
+	m_bActive{true},
+	m_nSilentBlocks{},
+	m_nSampleRate{samplerate},
+	m_bRefreshPending{},
+	m_bReleaseAllPending{},
+	m_uchOPMask{0x3F},
+	m_bOPMaskPending{},
+	m_nVoiceLoads{},
+	m_nLoadedVoice{},
+	m_VoiceState{VoiceEmpty},
+	m_nMailboxVoice{}
 	{
+		assert(maxnotes <= 32); // for m_nFadingVoices
+		Dexed::getVoiceData(m_VoiceData);
 	}
 
+	// Core 0 keeps a copy of the voice data, which the readers see. The latest
+	// voice is kept in a mailbox until the render core loads it, the edits of
+	// the voice are queued as commands. Commands for a voice replaced by a
+	// later load are skipped.
+
 	void loadVoiceParameters(uint8_t *data)
 	{
-		m_SpinLock.Acquire();
-		Dexed::loadVoiceParameters(data);
-		m_SpinLock.Release();
+		EnterCritical();
+		memcpy(m_VoiceData, data, VoiceSize);
+		postVoice();
+		LeaveCritical();
 	}
 
-	void keyup(uint8_t pitch)
+	void getVoiceData(uint8_t *data_copy)
 	{
-		m_SpinLock.Acquire();
-		Dexed::keyup(pitch);
-		m_SpinLock.Release();
+		memcpy(data_copy, m_VoiceData, VoiceDataSize);
 	}
 
-	void keydown(uint8_t pitch, uint8_t velo)
+	void getName(char *buffer)
 	{
-		m_SpinLock.Acquire();
-		Dexed::keydown(pitch, velo);
-		m_SpinLock.Release();
+		memcpy(buffer, &m_VoiceData[VoiceNameOffset], VoiceNameSize);
+		buffer[VoiceNameSize] = '\0';
 	}
 
-	void getSamples(float *buffer, int n_samples)
+	void setName(char *name)
 	{
-		m_SpinLock.Acquire();
-		Dexed::getSamples(buffer, static_cast<uint16_t>(n_samples));
-		EQ.process(buffer, n_samples);
-		if (m_bCompressorEnable)
+		for (int i = 0, nEnd = 0; i < VoiceNameSize; ++i)
 		{
-			Compr.doCompression(buffer, static_cast<uint16_t>(n_samples));
+			nEnd = nEnd || !name[i];
+			setVoiceDataElement(static_cast<uint8_t>(VoiceNameOffset + i), nEnd ? ' ' : static_cast<uint8_t>(name[i]));
 		}
-		m_SpinLock.Release();
 	}
 
-	void ControllersRefresh()
+	uint8_t getVoiceDataElement(uint8_t address)
+	{
+		if (address < VoiceDataSize)
+		{
+			return m_VoiceData[address];
+		}
+
+		return Dexed::getVoiceDataElement(address);
+	}
+
+	void setVoiceDataElement(uint8_t address, uint8_t value)
+	{
+		EnterCritical();
+		if (address < VoiceDataSize)
+		{
+			m_VoiceData[address] = value;
+		}
+		queueCommand(CommandVoiceData, address, value);
+		LeaveCritical();
+	}
+
+	void setTranspose(uint8_t transpose)
+	{
+		EnterCritical();
+		m_VoiceData[DEXED_VOICE_OFFSET + DEXED_TRANSPOSE] = transpose;
+		queueCommand(CommandTranspose, transpose, 0);
+		LeaveCritical();
+	}
+
+	// applied at the start of the next block, and again after a voice is loaded
+	void setOPAll(uint8_t ops)
+	{
+		m_uchOPMask.store(ops, std::memory_order_relaxed);
+		m_bOPMaskPending.store(true, std::memory_order_release);
+	}
+
+	// Key and pedal events are timestamped and applied by getSamples()
+	// at their position in the next block.
+
+	void keyup(uint8_t pitch)
+	{
+		queueCommand(CommandKeyUp, pitch, 0);
+	}
+
+	void keydown(uint8_t pitch, uint8_t velo)
 	{
-		m_SpinLock.Acquire();
-		Dexed::ControllersRefresh();
-		m_SpinLock.Release();
+		m_bActive = true;
+		queueCommand(CommandKeyDown, pitch, velo);
 	}
 
 	void setSustain(bool sustain)
 	{
-		m_SpinLock.Acquire();
-		Dexed::setSustain(sustain);
-		m_SpinLock.Release();
+		queueCommand(CommandSustain, sustain, 0);
+	}
+
+	void setSostenuto(bool sostenuto)
+	{
+		queueCommand(CommandSostenuto, sostenuto, 0);
+	}
+
+	void setHold(bool hold)
+	{
+		queueCommand(CommandHold, hold, 0);
+	}
+
+	void notesOff()
+	{
+		queueCommand(CommandNotesOff, 0, 0);
+	}
+
+	void panic()
+	{
+		queueCommand(CommandPanic, 0, 0);
+	}
+
+	void deactivate()
+	{
+		queueCommand(CommandDeactivate, 0, 0);
+	}
+
+	void resetState()
+	{
+		queueCommand(CommandResetState, 0, 0);
+	}
+
+	// applied once at the start of the next block, however often requested
+	void ControllersRefresh()
+	{
+		m_bRefreshPending.store(true, std::memory_order_release);
 	}
 
 	void setCompressorEnable(bool enable)
 	{
-		m_SpinLock.Acquire();
 		m_bCompressorEnable = enable;
-		m_SpinLock.Release();
 	}
 
-	void resetState()
+	// set by the load governor, 0 for no limit
+	void setVoiceLimit(int nVoices)
+	{
+		m_nVoiceLimit.store(nVoices, std::memory_order_relaxed);
+	}
+
+	// render core only, nBlockTicks is the time of the block, the same for all TGs
+	void getSamples(float *buffer, int n_samples, unsigned nBlockTicks)
+	{
+		// taken before the commands, which were queued before it
+		bool bReleaseAll = m_bReleaseAllPending.exchange(false, std::memory_order_acquire);
+
+		// commands queued while this block is rendered are left for the next one,
+		// the voice loaded after counting them is the one they are queued for
+		unsigned nCount = m_Commands.GetCount();
+
+		bool bLoaded = false;
+#ifndef ARM_ALLOW_MULTI_CORE
+		// core 0 renders, postVoice() from an IRQ would wait for it forever
+		EnterCritical();
+#endif
+		int nState = VoiceReady;
+		if (m_VoiceState.compare_exchange_strong(nState, VoiceReading, std::memory_order_acquire))
+		{
+			Dexed::loadVoiceParameters(m_VoiceMailbox);
+			m_nLoadedVoice = m_nMailboxVoice;
+			m_VoiceState.store(VoiceEmpty, std::memory_order_release);
+			bLoaded = true;
+		}
+#ifndef ARM_ALLOW_MULTI_CORE
+		LeaveCritical();
+#endif
+
+		if (m_bOPMaskPending.exchange(false, std::memory_order_acquire) || bLoaded)
+		{
+			Dexed::setOPAll(m_uchOPMask.load(std::memory_order_relaxed));
+		}
+
+		if (m_bRefreshPending.exchange(false, std::memory_order_acquire))
+		{
+			Dexed::ControllersRefresh();
+		}
+
+		m_nBlockVoiceLimit = m_nVoiceLimit.load(std::memory_order_relaxed);
+		if (m_nBlockVoiceLimit && m_nActiveVoices > m_nBlockVoiceLimit)
+		{
+			limitVoices(m_nBlockVoiceLimit, false);
+		}
+
+		int nDone = 0;
+		for (; nCount > 0; --nCount)
+		{
+			TCommand Command;
+			m_Commands.Get(&Command);
+
+			int nOffset = getCommandOffset(Command.nTicks, nBlockTicks, n_samples);
+			if (nOffset > nDone)
+			{
+				Dexed::getSamples(buffer + nDone, static_cast<uint16_t>(nOffset - nDone));
+				nDone = nOffset;
+			}
+
+			applyCommand(Command);
+		}
+
+		if (bReleaseAll)
+		{
+			Dexed::setSustain(false);
+			Dexed::setSostenuto(false);
+			Dexed::setHold(false);
+			Dexed::notesOff();
+		}
+
+		if (nDone < n_samples)
+		{
+			Dexed::getSamples(buffer + nDone, static_cast<uint16_t>(n_samples - nDone));
+		}
+
+		EQ.process(buffer, n_samples);
+		if (m_bCompressorEnable)
+		{
+			Compr.doCompression(buffer, static_cast<uint16_t>(n_samples));
+		}
+		m_nActiveVoices = getNumNotesPlaying();
+		updateActivity(buffer, n_samples);
+	}
+
+	// An inactive TG has no voices and its EQ and compressor tail
+	// has decayed, it need not be rendered nor mixed until next keydown.
+	bool isActive() const
+	{
+		return m_bActive.load(std::memory_order_relaxed);
+	}
+
+	// a TG with pending commands must be rendered, even if inactive
+	bool hasPendingCommands() const
+	{
+		return !m_Commands.IsEmpty() ||
+		       m_bRefreshPending.load(std::memory_order_relaxed) ||
+		       m_bReleaseAllPending.load(std::memory_order_relaxed) ||
+		       m_VoiceState.load(std::memory_order_relaxed) != VoiceEmpty;
+	}
+
+	// voices sounding at the end of the last block, used as cost estimate
+	int getActiveVoices() const
 	{
-		m_SpinLock.Acquire();
-		deactivate();
-		resetFxState();
-		EQ.resetState();
-		Compr.resetStates();
-		m_SpinLock.Release();
+		return m_nActiveVoices;
 	}
 
 	AudioEffect3BandEQMono EQ;
 	Compressor Compr;
 
 private:
-	CSpinLock m_SpinLock;
-	bool m_bCompressorEnable;
+	enum TCommandType
+	{
+		CommandKeyDown,
+		CommandKeyUp,
+		CommandSustain,
+		CommandSostenuto,
+		CommandHold,
+		CommandNotesOff,
+		CommandPanic,
+		CommandDeactivate,
+		CommandResetState,
+		CommandVoiceData,
+		CommandTranspose
+	};
+
+	struct TCommand
+	{
+		TCommandType Type;
+		uint8_t uchParam;
+		uint8_t uchVelocity; // or the value of the voice data
+		unsigned nTicks;
+		unsigned nVoice; // voice loads before
+	};
+
+	enum TVoiceState
+	{
+		VoiceEmpty,
+		VoiceWriting,
+		VoiceReady,
+		VoiceReading
+	};
+
+	// If the render core fell far behind, the last slots are reserved for the
+	// commands, which release notes or edit the voice, and other commands are
+	// dropped. If even these do not fit, all notes and pedals are released
+	// after the queued commands, so that no note hangs, and the edited voice
+	// is loaded again.
+	void queueCommand(TCommandType Type, uint8_t uchParam, uint8_t uchVelocity)
+	{
+		EnterCritical();
+		bool bReserved = isReserved(Type, uchParam);
+		// the count may be too high here, never too low
+		unsigned nFree = MaxCommands - m_Commands.GetCount();
+		if (nFree > (bReserved ? 0 : ReservedCommands))
+		{
+			m_Commands.Put({Type, uchParam, uchVelocity, CTimer::GetClockTicks(), m_nVoiceLoads});
+		}
+		else if (Type == CommandVoiceData || Type == CommandTranspose)
+		{
+			postVoice();
+		}
+		else if (bReserved)
+		{
+			m_bReleaseAllPending.store(true, std::memory_order_release);
+		}
+		LeaveCritical();
+	}
+
+	static bool isReserved(TCommandType Type, uint8_t uchParam)
+	{
+		switch (Type)
+		{
+		case CommandKeyDown:
+			return false;
+
+		case CommandSustain:
+		case CommandSostenuto:
+		case CommandHold:
+			return !uchParam;
+
+		default:
+			return true;
+		}
+	}
+
+	void applyCommand(const TCommand &Command)
+	{
+		switch (Command.Type)
+		{
+		case CommandKeyDown:
+			// a new voice must not exceed the limit
+			if (m_nBlockVoiceLimit)
+			{
+				limitVoices(m_nBlockVoiceLimit - 1, true);
+			}
+			Dexed::keydown(Command.uchParam, Command.uchVelocity);
+			countVoices();
+			break;
+
+		case CommandKeyUp:
+			Dexed::keyup(Command.uchParam);
+			break;
+
+		case CommandSustain:
+			Dexed::setSustain(Command.uchParam);
+			break;
+
+		case CommandSostenuto:
+			Dexed::setSostenuto(Command.uchParam);
+			break;
+
+		case CommandHold:
+			Dexed::setHold(Command.uchParam);
+			break;
+
+		case CommandNotesOff:
+			Dexed::notesOff();
+			break;
+
+		case CommandPanic:
+			Dexed::panic();
+			break;
+
+		case CommandDeactivate:
+			Dexed::deactivate();
+			break;
+
+		case CommandResetState:
+			Dexed::deactivate();
+			resetFxState();
+			EQ.resetState();
+			Compr.resetStates();
+			break;
+
+		case CommandVoiceData:
+			if (Command.nVoice == m_nLoadedVoice)
+			{
+				Dexed::setVoiceDataElement(Command.uchParam, Command.uchVelocity);
+			}
+			break;
+
+		case CommandTranspose:
+			if (Command.nVoice == m_nLoadedVoice)
+			{
+				Dexed::setTranspose(Command.uchParam);
+			}
+			break;
+		}
+	}
+
+	// Passes the voice data of core 0 to the render core as a new voice.
+	// Must be called with IRQs disabled. The render core reads the mailbox
+	// on another core or, without multi core, with IRQs disabled, so that
+	// the wait here always ends.
+	void postVoice()
+	{
+		// wait while the render core copies from the mailbox
+		int nState = m_VoiceState.load(std::memory_order_relaxed);
+		while (nState == VoiceReading || !m_VoiceState.compare_exchange_weak(nState, VoiceWriting, std::memory_order_acquire))
+		{
+			nState = m_VoiceState.load(std::memory_order_relaxed);
+		}
+
+		memcpy(m_VoiceMailbox, m_VoiceData, VoiceSize);
+		m_nMailboxVoice = ++m_nVoiceLoads;
+		m_VoiceState.store(VoiceReady, std::memory_order_release);
+	}
+
+	// Commands are delayed by one block, so that their distance is kept.
+	// Dexed renders in steps of _N_ samples, which limits the resolution.
+	// Commands queued after the block time are the latest.
+	int getCommandOffset(unsigned nTicks, unsigned nBlockTicks, int n_samples) const
+	{
+		int nAge = std::max(0, static_cast<int>(nBlockTicks - nTicks));
+		uint64_t nAgeFrames = static_cast<uint64_t>(nAge) * m_nSampleRate / CLOCKHZ;
+		if (nAgeFrames >= static_cast<uint64_t>(n_samples))
+		{
+			return 0;
+		}
+
+		int nOffset = n_samples - static_cast<int>(nAgeFrames);
+		return nOffset - nOffset % _N_;
+	}
+
+	// Fades out the quietest voices, until at most nMaxVoices are sounding.
+	// Released voices are taken first, voices held by a key or a pedal
+	// (sustain, sostenuto or hold) only with bHeld. Only the carriers are heard, so their level counts.
+	void limitVoices(int nMaxVoices, bool bHeld)
+	{
+		uint8_t uchCarriers = controllers.core->get_carrier_operators(data[DEXED_VOICE_OFFSET + DEXED_ALGORITHM]);
+
+		for (int nSounding = countVoices(); nSounding > nMaxVoices; --nSounding)
+		{
+			int nQuietest = -1;
+			bool bQuietestHeld = true;
+			uint64_t nMinAmp = UINT64_MAX;
+
+			for (int i = 0; i < max_notes; ++i)
+			{
+				bool bIsHeld = isHeld(voices[i]);
+				if (!voices[i].live || (m_nFadingVoices & (1u << i)) || (bIsHeld && !bHeld))
+				{
+					continue;
+				}
+
+				VoiceStatus Status;
+				voices[i].dx7_note->peekVoiceStatus(Status);
+
+				uint64_t nAmp = 0;
+				for (int op = 0; op < 6; ++op)
+				{
+					if (uchCarriers & (1 << op))
+					{
+						nAmp += Status.amp[op];
+					}
+				}
+
+				if ((!bIsHeld && bQuietestHeld) || (bIsHeld == bQuietestHeld && nAmp < nMinAmp))
+				{
+					nMinAmp = nAmp;
+					nQuietest = i;
+					bQuietestHeld = bIsHeld;
+				}
+			}
+
+			if (nQuietest < 0)
+			{
+				break;
+			}
+
+			fadeVoice(nQuietest);
+		}
+	}
+
+	// The voice is released with the fastest rate of its envelopes, so that it
+	// fades out within a few milliseconds instead of being cut off.
+	void fadeVoice(int nVoice)
+	{
+		uint8_t Patch[VoiceDataSize];
+		memcpy(Patch, data, sizeof Patch);
+		for (int op = 0; op < 6; ++op)
+		{
+			Patch[op * 21 + DEXED_OP_EG_R4] = 99;
+			Patch[op * 21 + DEXED_OP_EG_L4] = 0;
+		}
+
+		ProcessorVoice &Voice = voices[nVoice];
+		Voice.dx7_note->update(Patch, Voice.midi_note, Voice.velocity, Voice.porta, &controllers);
+		Voice.dx7_note->keyup();
+		Voice.keydown = false;
+		Voice.sustained = false;
+		Voice.sostenuted = false;
+		Voice.held = false;
+
+		m_nFadingVoices |= 1u << nVoice;
+	}
+
+	static bool isHeld(const ProcessorVoice &Voice)
+	{
+		return Voice.keydown || Voice.sustained || Voice.sostenuted || Voice.held;
+	}
+
+	// returns the voices sounding and not fading out, a fading voice
+	// ends or is taken for a new note by Dexed
+	int countVoices()
+	{
+		int nSounding = 0;
+		for (int i = 0; i < max_notes; ++i)
+		{
+			if (!voices[i].live || voices[i].keydown)
+			{
+				m_nFadingVoices &= ~(1u << i);
+			}
+
+			nSounding += voices[i].live && !(m_nFadingVoices & (1u << i));
+		}
+
+		return nSounding;
+	}
+
+	void updateActivity(const float *buffer, int n_samples)
+	{
+		if (m_nActiveVoices > 0)
+		{
+			m_nSilentBlocks = 0;
+			m_bActive = true;
+			return;
+		}
+
+		for (int i = 0; i < n_samples; ++i)
+		{
+			if (std::fabs(buffer[i]) > SilenceLevel)
+			{
+				m_nSilentBlocks = 0;
+				return;
+			}
+		}
+
+		if (++m_nSilentBlocks >= SilentBlocks)
+		{
+			m_bActive = false;
+		}
+	}
+
+	static constexpr float SilenceLevel = 1e-5f; // -100 dBFS
+	static constexpr int SilentBlocks = 4;
+	static constexpr unsigned MaxCommands = 256;
+	static constexpr unsigned ReservedCommands = 64; // for releasing commands
+
+	static constexpr int VoiceSize = 155; // without the operator enable
+	static constexpr int VoiceDataSize = 156;
+	static constexpr int VoiceNameOffset = 145;
+	static constexpr int VoiceNameSize = 10;
+
+	std::atomic<bool> m_bCompressorEnable;
+	int m_nActiveVoices;
+	std::atomic<int> m_nVoiceLimit;
+	int m_nBlockVoiceLimit; // render core only
+	uint32_t m_nFadingVoices; // render core only
+	std::atomic<bool> m_bActive;
+	int m_nSilentBlocks;
+
+	unsigned m_nSampleRate;
+	CSPSCQueue<TCommand, MaxCommands> m_Commands;
+	std::atomic<bool> m_bRefreshPending;
+	std::atomic<bool> m_bReleaseAllPending; // releasing commands did not fit
+	std::atomic<uint8_t> m_uchOPMask;
+	std::atomic<bool> m_bOPMaskPending;
+
+	uint8_t m_VoiceData[VoiceDataSize]; // core 0 only
+	unsigned m_nVoiceLoads; // core 0 only
+	unsigned m_nLoadedVoice; // render core only
+
+	std::atomic<int> m_VoiceState;
+	uint8_t m_VoiceMailbox[VoiceSize];
+	unsigned m_nMailboxVoice;
 };
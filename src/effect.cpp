@@ -222,6 +222,16 @@ int FX::getIDFromName(Parameter param, const char *name)
 	return 0;
 }
 
+// returns the effect, which owns the parameter, or 0
+int FX::getEffectID(Parameter param)
+{
+	for (int i = 1; i < FX::effects_num; ++i)
+		if (param >= FX::s_effects[i].MinID && param <= FX::s_effects[i].MaxID)
+			return i;
+
+	return 0;
+}
+
 const char *FX::getNameFromID(Parameter param, int nID)
 {
 	switch (param)
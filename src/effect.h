@@ -199,6 +199,23 @@ public:
 
 	static FX::ParameterType s_Parameter[];
 
+	// index of s_effects
+	enum EffectID
+	{
+		None,
+		ZynDistortion,
+		YKChorus,
+		ZynChorus,
+		ZynSympathetic,
+		ZynAPhaser,
+		ZynPhaser,
+		DreamDelay,
+		PlateReverb,
+		CloudSeed2,
+		Compressor,
+		EQ,
+	};
+
 	struct EffectType
 	{
 		const char *Name;
@@ -225,4 +242,5 @@ public:
 
 	static const char *getNameFromID(Parameter param, int nID);
 	static int getIDFromName(Parameter param, const char *name);
+	static int getEffectID(Parameter param);
 };
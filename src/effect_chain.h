@@ -1,11 +1,15 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
 #include <functional>
+#include <vector>
 
 #include <dsp/basic_math_functions.h>
+#include <dsp/support_functions.h>
 
 #include "common.h"
 #include "effect.h"
@@ -15,57 +19,159 @@
 #include "effect_dreamdelay.h"
 #include "effect_platervbstereo.h"
 #include "effect_ykchorus.h"
+#include "perftimer.h"
 #include "zyn/APhaser.h"
 #include "zyn/Chorus.h"
 #include "zyn/Distortion.h"
 #include "zyn/Phaser.h"
 #include "zyn/Sympathetic.h"
 
+// Free effect engines, which are given to the FX chains when a slot selects them.
+// Only used by core 0.
+class AudioFXPool
+{
+public:
+	AudioFXPool(float samplerate) :
+	samplerate{samplerate}
+	{
+	}
+
+	void *get(int id)
+	{
+		assert(id > 0 && id < FX::effects_num);
+
+		if (free[id].empty())
+			return create(id);
+
+		void *fx = free[id].back();
+		free[id].pop_back();
+		return fx;
+	}
+
+	void put(int id, void *fx)
+	{
+		assert(id > 0 && id < FX::effects_num);
+		assert(fx);
+
+		free[id].push_back(fx);
+	}
+
+	float get_samplerate() const { return samplerate; }
+
+private:
+	void *create(int id)
+	{
+		switch (id)
+		{
+		case FX::ZynDistortion: return new zyn::Distortion{samplerate};
+		case FX::YKChorus: return new AudioEffectYKChorus{samplerate};
+		case FX::ZynChorus: return new zyn::Chorus{samplerate};
+		case FX::ZynSympathetic: return new zyn::Sympathetic{samplerate};
+		case FX::ZynAPhaser: return new zyn::APhaser{samplerate};
+		case FX::ZynPhaser: return new zyn::Phaser{samplerate};
+		case FX::DreamDelay: return new AudioEffectDreamDelay{samplerate};
+		case FX::PlateReverb: return new AudioEffectPlateReverb{samplerate};
+		case FX::CloudSeed2: return new AudioEffectCloudSeed2{samplerate};
+		case FX::Compressor: return new AudioEffectCompressor{samplerate};
+		case FX::EQ: return new AudioEffect3BandEQ{samplerate};
+		default: assert(0); return nullptr;
+		}
+	}
+
+	float samplerate;
+	std::vector<void *> free[FX::effects_num];
+};
+
 class AudioFXChain
 {
 public:
 	typedef std::function<void(float *inputL, float *inputR, int len)> process_t;
 
-	AudioFXChain(float samplerate) :
-	zyn_distortion{samplerate},
-	yk_chorus{samplerate},
-	zyn_chorus{samplerate},
-	zyn_sympathetic{samplerate},
-	zyn_aphaser{samplerate},
-	zyn_phaser{samplerate},
-	dream_delay{samplerate},
-	plate_reverb{samplerate},
-	cloudseed2{samplerate},
-	compressor{samplerate},
-	eq{samplerate},
+	// the effect engines of the chain, null if not created
+	struct Effects
+	{
+		zyn::Distortion *zyn_distortion;
+		AudioEffectYKChorus *yk_chorus;
+		zyn::Chorus *zyn_chorus;
+		zyn::Sympathetic *zyn_sympathetic;
+		zyn::APhaser *zyn_aphaser;
+		zyn::Phaser *zyn_phaser;
+		AudioEffectDreamDelay *dream_delay;
+		AudioEffectPlateReverb *plate_reverb;
+		AudioEffectCloudSeed2 *cloudseed2;
+		AudioEffectCompressor *compressor;
+		AudioEffect3BandEQ *eq;
+
+		bool has(int id) const
+		{
+			switch (id)
+			{
+			case FX::ZynDistortion: return zyn_distortion;
+			case FX::YKChorus: return yk_chorus;
+			case FX::ZynChorus: return zyn_chorus;
+			case FX::ZynSympathetic: return zyn_sympathetic;
+			case FX::ZynAPhaser: return zyn_aphaser;
+			case FX::ZynPhaser: return zyn_phaser;
+			case FX::DreamDelay: return dream_delay;
+			case FX::PlateReverb: return plate_reverb;
+			case FX::CloudSeed2: return cloudseed2;
+			case FX::Compressor: return compressor;
+			case FX::EQ: return eq;
+			default: return false;
+			}
+		}
+	};
+
+	// scratch holds 2 * max_len samples
+	AudioFXChain(AudioFXPool *pool, CAudioProfiler *profiler, int profiler_stage, float *scratch, int max_len) :
 	bypass{},
+	pool{pool},
+	profiler{profiler},
+	profiler_stage{profiler_stage},
+	scratch{scratch},
+	max_len{max_len},
+	effects{},
+	slots{},
 	funcs{
 		[](float *inputL, float *inputR, int len) {},
 		[this](float *inputL, float *inputR, int len)
-		{ zyn_distortion.process(inputL, inputR, len); },
+		{ get<zyn::Distortion>(FX::ZynDistortion)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ yk_chorus.process(inputL, inputR, len); },
+		{ get<AudioEffectYKChorus>(FX::YKChorus)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ zyn_chorus.process(inputL, inputR, len); },
+		{ get<zyn::Chorus>(FX::ZynChorus)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ zyn_sympathetic.process(inputL, inputR, len); },
+		{ get<zyn::Sympathetic>(FX::ZynSympathetic)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ zyn_aphaser.process(inputL, inputR, len); },
+		{ get<zyn::APhaser>(FX::ZynAPhaser)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ zyn_phaser.process(inputL, inputR, len); },
+		{ get<zyn::Phaser>(FX::ZynPhaser)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ dream_delay.process(inputL, inputR, len); },
+		{ get<AudioEffectDreamDelay>(FX::DreamDelay)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ plate_reverb.process(inputL, inputR, inputL, inputR, len); },
+		{ get<AudioEffectPlateReverb>(FX::PlateReverb)->process(inputL, inputR, inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ cloudseed2.process(inputL, inputR, len); },
+		{ get<AudioEffectCloudSeed2>(FX::CloudSeed2)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ compressor.process(inputL, inputR, len); },
+		{ get<AudioEffectCompressor>(FX::Compressor)->process(inputL, inputR, len); },
 		[this](float *inputL, float *inputR, int len)
-		{ eq.process(inputL, inputR, len); },
+		{ get<AudioEffect3BandEQ>(FX::EQ)->process(inputL, inputR, len); },
 	},
-	level{}
+	level{},
+	shed{},
+	wet{},
+	cost{},
+	shed_ramp{1.0f / (ShedFadeTime * pool->get_samplerate())},
+	sleep_id{},
+	quiet{},
+	asleep{},
+	short_tail{static_cast<int>(ShortTailTime * pool->get_samplerate())},
+	long_tail{static_cast<int>(LongTailTime * pool->get_samplerate())},
+	unselected{},
+	unselected_block{}
 	{
+		for (int i = 0; i < FX::slots_num; ++i)
+			wet[i] = 1.0f;
 	}
 
 	float get_level() { return level; }
@@ -75,9 +181,68 @@ public:
 	{
 		if (bypass) return;
 
+		// Silent signals are zeroed, so that the output of a slot with silent
+		// input holds only its internal state, scaled by its wet gain.
+		bool silent = is_silent(inputL, inputR, SilenceLevel, len);
+		if (silent)
+			zero_fill(inputL, inputR, len);
+
 		for (int i = 0; i < FX::slots_num; ++i)
 			if (int id = slots[i])
-				funcs[id](inputL, inputR, len);
+			{
+				if (sleep_id[i] != id)
+				{
+					sleep_id[i] = id;
+					quiet[i] = 0;
+					asleep[i] = false;
+				}
+
+				// The tail of a sleeping effect has decayed below the silence
+				// threshold, so it resumes without a click.
+				if (asleep[i])
+				{
+					if (silent && get_tail_frames(id))
+						continue;
+
+					asleep[i] = false;
+					quiet[i] = 0;
+				}
+
+				float target = shed[i].load(std::memory_order_relaxed) ? 0.0f : 1.0f;
+				if (wet[i] == 0.0f && target == 0.0f)
+					continue;
+
+				unsigned start = CTimer::GetClockTicks();
+
+				if (wet[i] == target)
+					funcs[id](inputL, inputR, len);
+				else
+					process_fading(i, id, target, inputL, inputR, len);
+
+				profiler->Stop(profiler_stage + i, start);
+
+				unsigned ticks = CTimer::GetClockTicks() - start;
+				unsigned average = cost[i].load(std::memory_order_relaxed);
+				cost[i].store(average - average / 8 + ticks / 8, std::memory_order_relaxed);
+
+				// a non-silent input is not checked at the output again
+				if (silent)
+				{
+					silent = is_silent(inputL, inputR, SilenceLevel * wet[i] * get_wet_gain(id), len);
+					if (silent)
+						zero_fill(inputL, inputR, len);
+				}
+
+				if (silent)
+				{
+					int tail = get_tail_frames(id);
+					if (quiet[i] < tail)
+						quiet[i] += len;
+					asleep[i] = tail && quiet[i] >= tail;
+				}
+				else
+					quiet[i] = 0;
+			}
 
 		if (level != 1.0f)
 		{
@@ -88,45 +253,299 @@ public:
 
 	void resetState()
 	{
-		zyn_distortion.cleanup();
-		zyn_chorus.cleanup();
-		zyn_sympathetic.cleanup();
-		zyn_aphaser.cleanup();
-		zyn_phaser.cleanup();
-		dream_delay.resetState();
-		plate_reverb.reset();
-		compressor.resetState();
-		eq.resetState();
+		Effects fx = get_effects();
+
+		if (fx.zyn_distortion) fx.zyn_distortion->cleanup();
+		if (fx.zyn_chorus) fx.zyn_chorus->cleanup();
+		if (fx.zyn_sympathetic) fx.zyn_sympathetic->cleanup();
+		if (fx.zyn_aphaser) fx.zyn_aphaser->cleanup();
+		if (fx.zyn_phaser) fx.zyn_phaser->cleanup();
+		if (fx.dream_delay) fx.dream_delay->resetState();
+		if (fx.plate_reverb) fx.plate_reverb->reset();
+		if (fx.compressor) fx.compressor->resetState();
+		if (fx.eq) fx.eq->resetState();
+
+		if (fx.cloudseed2)
+		{
+			fx.cloudseed2->setRampedDown();
+			fx.cloudseed2->setNeedBufferClear();
+		}
+	}
+
+	// Under overload the most expensive slots are faded out and not processed
+	// anymore, until they are restored. Called by the load governor on core 1.
+	void shed_slots(int count)
+	{
+		bool shedding[FX::slots_num] = {};
+
+		for (int n = 0; n < count; ++n)
+		{
+			int max_slot = -1;
+			for (int i = 0; i < FX::slots_num; ++i)
+				if (slots[i] && !shedding[i] && (max_slot < 0 || cost[i] > cost[max_slot]))
+					max_slot = i;
+
+			if (max_slot < 0)
+				break;
 
-		cloudseed2.setRampedDown();
-		cloudseed2.setNeedBufferClear();
+			shedding[max_slot] = true;
+		}
+
+		for (int i = 0; i < FX::slots_num; ++i)
+			shed[i].store(shedding[i], std::memory_order_relaxed);
+	}
+
+	int get_active_slots() const
+	{
+		int n = 0;
+		for (int i = 0; i < FX::slots_num; ++i)
+			if (slots[i])
+				++n;
+		return n;
 	}
 
+	// the effect must have been created before
 	void setSlot(int slot, int effect_id)
 	{
 		assert(slot >= 0 && slot < FX::slots_num);
 		assert(effect_id >= 0 && effect_id < FX::effects_num);
+		assert(effect_id == 0 || has_effect(effect_id));
 
 		slots[slot] = effect_id;
 	}
 
-	zyn::Distortion zyn_distortion;
-	AudioEffectYKChorus yk_chorus;
-	zyn::Chorus zyn_chorus;
-	zyn::Sympathetic zyn_sympathetic;
-	zyn::APhaser zyn_aphaser;
-	zyn::Phaser zyn_phaser;
-	AudioEffectDreamDelay dream_delay;
-	AudioEffectPlateReverb plate_reverb;
-	AudioEffectCloudSeed2 cloudseed2;
-	AudioEffectCompressor compressor;
-	AudioEffect3BandEQ eq;
+	// Load the pointers only once per use, core 0 may release an effect meanwhile.
+	Effects get_effects() const
+	{
+		return {
+			get<zyn::Distortion>(FX::ZynDistortion),
+			get<AudioEffectYKChorus>(FX::YKChorus),
+			get<zyn::Chorus>(FX::ZynChorus),
+			get<zyn::Sympathetic>(FX::ZynSympathetic),
+			get<zyn::APhaser>(FX::ZynAPhaser),
+			get<zyn::Phaser>(FX::ZynPhaser),
+			get<AudioEffectDreamDelay>(FX::DreamDelay),
+			get<AudioEffectPlateReverb>(FX::PlateReverb),
+			get<AudioEffectCloudSeed2>(FX::CloudSeed2),
+			get<AudioEffectCompressor>(FX::Compressor),
+			get<AudioEffect3BandEQ>(FX::EQ),
+		};
+	}
+
+	bool has_effect(int id) const
+	{
+		assert(id > 0 && id < FX::effects_num);
+		return effects[id].load(std::memory_order_acquire) != nullptr;
+	}
+
+	//
+	// The effects are created from the pool, when they are selected, and given back to
+	// the pool a few blocks after they are unselected. The block numbers count the
+	// processed audio blocks, an effect is not used anymore two blocks after it
+	// has been unselected or unpublished. Only called by core 0.
+	//
+
+	// returns true, if the effect has been created and its parameters must be set
+	bool select_effect(int id)
+	{
+		assert(id > 0 && id < FX::effects_num);
+
+		unselected[id] = false;
+
+		if (has_effect(id))
+			return false;
+
+		void *fx = pool->get(id);
+		reset_effect(id, fx);
+		effects[id].store(fx, std::memory_order_release);
+
+		return true;
+	}
+
+	void unselect_effect(int id, unsigned block)
+	{
+		assert(id > 0 && id < FX::effects_num);
+
+		if (!has_effect(id))
+			return;
+
+		unselected[id] = true;
+		unselected_block[id] = block;
+	}
+
+	bool is_unused(int id, unsigned block) const
+	{
+		assert(id > 0 && id < FX::effects_num);
+		return unselected[id] && block - unselected_block[id] >= 2;
+	}
+
+	void release_effect(int id, unsigned block)
+	{
+		assert(is_unused(id, block));
+
+		void *fx = effects[id].exchange(nullptr, std::memory_order_acq_rel);
+		retired.push_back({id, fx, block});
+		unselected[id] = false;
+	}
+
+	void reclaim_effects(unsigned block)
+	{
+		for (auto it = retired.begin(); it != retired.end();)
+		{
+			if (block - it->block >= 2)
+			{
+				pool->put(it->id, it->fx);
+				it = retired.erase(it);
+			}
+			else
+				++it;
+		}
+	}
 
 	std::atomic<bool> bypass;
 
 private:
+	static constexpr float ShedFadeTime = 0.02f; // seconds
+	static constexpr float ShortTailTime = 0.1f; // seconds
+	static constexpr float LongTailTime = 2.0f; // seconds
+	static constexpr float SilenceLevel = 1e-5f; // -100 dBFS
+
+	static bool is_silent(const float *inputL, const float *inputR, float threshold, int len)
+	{
+		for (int n = 0; n < len; ++n)
+			if (fabsf(inputL[n]) > threshold || fabsf(inputR[n]) > threshold)
+				return false;
+
+		return true;
+	}
+
+	static void zero_fill(float *inputL, float *inputR, int len)
+	{
+		arm_fill_f32(0.0f, inputL, static_cast<uint32_t>(len));
+		arm_fill_f32(0.0f, inputR, static_cast<uint32_t>(len));
+	}
+
+	// Frames of silent output with silent input, after which an effect can sleep,
+	// 0 while it must be processed anyway. Effects with a delay line must be
+	// quiet for at least its length, as it may still hold the input.
+	int get_tail_frames(int id) const
+	{
+		switch (id)
+		{
+		case FX::DreamDelay: return get<AudioEffectDreamDelay>(id)->getTailFrames();
+		case FX::CloudSeed2:
+		{
+			AudioEffectCloudSeed2 *fx = get<AudioEffectCloudSeed2>(id);
+			if (!fx->isIdle())
+				return 0;
+
+			// its output levels are not known, so its decay time is waited for
+			return std::max(long_tail, static_cast<int>(fx->getTailTime() * pool->get_samplerate()));
+		}
+		default: return short_tail;
+		}
+	}
+
+	// Gain of the internal state at the output of an effect. The output of an
+	// effect with a low wet gain gets silent long before its state.
+	float get_wet_gain(int id) const
+	{
+		switch (id)
+		{
+		case FX::ZynDistortion: return get<zyn::Distortion>(id)->getwet();
+		case FX::YKChorus: return get<AudioEffectYKChorus>(id)->getWet();
+		case FX::ZynChorus: return get<zyn::Chorus>(id)->getwet();
+		case FX::ZynSympathetic: return get<zyn::Sympathetic>(id)->getwet();
+		case FX::ZynAPhaser: return get<zyn::APhaser>(id)->getwet();
+		case FX::ZynPhaser: return get<zyn::Phaser>(id)->getwet();
+		case FX::DreamDelay: return get<AudioEffectDreamDelay>(id)->getWet();
+		case FX::PlateReverb: return get<AudioEffectPlateReverb>(id)->get_wet();
+		default: return 1.0f;
+		}
+	}
+
+	// crossfades between the dry input and the output of the slot
+	void process_fading(int slot, int id, float target, float *inputL, float *inputR, int len)
+	{
+		assert(len <= max_len);
+
+		float *dryL = scratch;
+		float *dryR = scratch + max_len;
+		arm_copy_f32(inputL, dryL, static_cast<uint32_t>(len));
+		arm_copy_f32(inputR, dryR, static_cast<uint32_t>(len));
+
+		funcs[id](inputL, inputR, len);
+
+		float step = target > wet[slot] ? shed_ramp : -shed_ramp;
+		float gain = wet[slot];
+		for (int n = 0; n < len; ++n)
+		{
+			gain = constrain(gain + step, 0.0f, 1.0f);
+			inputL[n] = dryL[n] + (inputL[n] - dryL[n]) * gain;
+			inputR[n] = dryR[n] + (inputR[n] - dryR[n]) * gain;
+		}
+
+		wet[slot] = gain;
+	}
+
+	template <typename T>
+	T *get(int id) const
+	{
+		return static_cast<T *>(effects[id].load(std::memory_order_acquire));
+	}
+
+	// a reused effect must not keep the state of its former chain
+	static void reset_effect(int id, void *fx)
+	{
+		switch (id)
+		{
+		case FX::ZynDistortion: static_cast<zyn::Distortion *>(fx)->cleanup(); break;
+		case FX::ZynChorus: static_cast<zyn::Chorus *>(fx)->cleanup(); break;
+		case FX::ZynSympathetic: static_cast<zyn::Sympathetic *>(fx)->cleanup(); break;
+		case FX::ZynAPhaser: static_cast<zyn::APhaser *>(fx)->cleanup(); break;
+		case FX::ZynPhaser: static_cast<zyn::Phaser *>(fx)->cleanup(); break;
+		case FX::DreamDelay: static_cast<AudioEffectDreamDelay *>(fx)->resetState(); break;
+		case FX::PlateReverb: static_cast<AudioEffectPlateReverb *>(fx)->reset(); break;
+		case FX::CloudSeed2: static_cast<AudioEffectCloudSeed2 *>(fx)->reset(); break;
+		case FX::Compressor: static_cast<AudioEffectCompressor *>(fx)->resetState(); break;
+		case FX::EQ: static_cast<AudioEffect3BandEQ *>(fx)->resetState(); break;
+		default: break;
+		}
+	}
+
+	struct Retired
+	{
+		int id;
+		void *fx;
+		unsigned block;
+	};
+
+	AudioFXPool *pool;
+	CAudioProfiler *profiler;
+	int profiler_stage;
+	float *scratch;
+	int max_len;
+
+	std::atomic<void *> effects[FX::effects_num];
 	std::atomic<int> slots[FX::slots_num];
 	const process_t funcs[FX::effects_num];
 
 	float level;
+
+	std::atomic<bool> shed[FX::slots_num];
+	float wet[FX::slots_num]; // crossfade gain of the slots
+	std::atomic<unsigned> cost[FX::slots_num]; // average ticks of the slots
+	float shed_ramp;
+
+	// Slots, whose internal state stayed silent with silent input, sleep until
+	// the input is not silent anymore. Only used by the processing core.
+	int sleep_id[FX::slots_num];
+	int quiet[FX::slots_num]; // frames of silent state
+	bool asleep[FX::slots_num];
+	int short_tail;
+	int long_tail;
+
+	bool unselected[FX::effects_num];
+	unsigned unselected_block[FX::effects_num];
+	std::vector<Retired> retired;
 };
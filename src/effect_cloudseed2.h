@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cmath>
 #include <cstring>
 #include <string>
 
@@ -180,6 +181,29 @@ public:
 		vol = 0.0f;
 	}
 
+	// for a reused instance, a pending preset load is dropped
+	void reset()
+	{
+		needParameterLoad = 0;
+		setRampedDown();
+		setNeedBufferClear();
+	}
+
+	// no buffer clear, preset load or volume ramp is pending
+	bool isIdle()
+	{
+		return !needBufferClear && !waitBufferClear && !needParameterLoad && vol == targetVol;
+	}
+
+	// Seconds until the late lines decayed by 100 dB. The engine scales the
+	// decay parameter to a decay time (-60 dB) from 0.05 to 60 seconds.
+	float getTailTime()
+	{
+		double value = engine.GetAllParameters()[Cloudseed::Parameter::LateLineDecay];
+		double decay = 0.05 + (std::pow(10.0, 3.0 * value) - 1.0) / 999.0 * 59.95;
+		return static_cast<float>(decay * 100.0 / 60.0);
+	}
+
 	bool isDisabled()
 	{
 		double *params = engine.GetAllParameters();
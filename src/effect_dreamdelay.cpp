@@ -3,18 +3,33 @@
 #include <algorithm>
 #include <cassert>
 
+#include <dsp/basic_math_functions.h>
+#include <dsp/support_functions.h>
+
 #include "common.h"
 
 constexpr float MAX_DELAY_TIME = 2.0f;
 
+static int nextPowerOfTwo(int n)
+{
+	int size = 1;
+	while (size < n)
+		size <<= 1;
+	return size;
+}
+
 AudioEffectDreamDelay::AudioEffectDreamDelay(float samplerate) :
 bypass{},
 samplerate{samplerate},
 mode{DUAL},
-bufferSize{static_cast<int>(samplerate * MAX_DELAY_TIME)},
+maxDelay{static_cast<int>(samplerate * MAX_DELAY_TIME)},
+bufferSize{nextPowerOfTwo(maxDelay + 1)},
+bufferMask{bufferSize - 1},
 bufferL{new float[static_cast<unsigned>(bufferSize)]{}},
 bufferR{new float[static_cast<unsigned>(bufferSize)]{}},
 index{},
+tmpL{},
+tmpR{},
 timeLSync{},
 timeRSync{},
 feedback{0.6f},
@@ -46,16 +61,14 @@ void AudioEffectDreamDelay::setTimeL(float time)
 {
 	timeL = constrain(time, 0.0f, MAX_DELAY_TIME);
 	int offset = index - timeL * samplerate - (timeL ? 0 : 1);
-	if (offset < 0) offset += bufferSize;
-	indexDL = offset;
+	indexDL = offset & bufferMask;
 }
 
 void AudioEffectDreamDelay::setTimeR(float time)
 {
 	timeR = constrain(time, 0.0f, MAX_DELAY_TIME);
 	int offset = index - timeR * samplerate - (timeR ? 0 : 1);
-	if (offset < 0) offset += bufferSize;
-	indexDR = offset;
+	indexDR = offset & bufferMask;
 }
 
 void AudioEffectDreamDelay::setTimeLSync(Sync sync)
@@ -101,74 +114,138 @@ void AudioEffectDreamDelay::process(float *blockL, float *blockR, int len)
 
 	if (wet == 0.0f) return;
 
-	switch (mode)
+	int delayL = (index - indexDL) & bufferMask;
+	int delayR = (index - indexDR) & bufferMask;
+
+	// The spans neither wrap around the buffer nor are longer than the delays,
+	// so the samples read are never written in the same span.
+	// Very short delays would split the block into tiny spans, so these
+	// use the scalar loop for the whole block.
+	bool scalar = std::min(delayL, delayR) < MinSpan;
+
+	while (len > 0)
 	{
-	case DUAL:
-		for (int i = 0; i < len; i++)
-		{
-			float inL = blockL[i];
-			float inR = blockR[i];
+		int n = std::min({len, ChunkSize, delayL, delayR});
+		n = std::min({n, bufferSize - index, bufferSize - indexDL, bufferSize - indexDR});
 
-			float delayL = bufferL[indexDL];
-			float delayR = bufferR[indexDR];
+		if (scalar)
+			n = len;
 
-			bufferL[index] = lpf.processSampleL(inL) + delayL * feedback;
-			bufferR[index] = lpf.processSampleR(inR) + delayR * feedback;
+		if (scalar || n < MinSpan)
+			processSamples(blockL, blockR, n);
+		else
+			processSpan(blockL, blockR, n);
 
-			blockL[i] = inL * dry + delayL * wet;
-			blockR[i] = inR * dry + delayR * wet;
+		index = (index + n) & bufferMask;
+		indexDL = (indexDL + n) & bufferMask;
+		indexDR = (indexDR + n) & bufferMask;
 
-			indexDL = (indexDL + 1) % bufferSize;
-			indexDR = (indexDR + 1) % bufferSize;
-			index = (index + 1) % bufferSize;
-		}
-		break;
+		blockL += n;
+		blockR += n;
+		len -= n;
+	}
+}
 
-	case CROSSOVER:
-		for (int i = 0; i < len; i++)
+void AudioEffectDreamDelay::processSamples(float *blockL, float *blockR, int len)
+{
+	int iw = index;
+	int iL = indexDL;
+	int iR = indexDR;
+
+	for (int i = 0; i < len; i++)
+	{
+		float inL = blockL[i];
+		float inR = blockR[i];
+
+		float delayL = bufferL[iL];
+		float delayR = bufferR[iR];
+
+		switch (mode)
 		{
-			float inL = blockL[i];
-			float inR = blockR[i];
+		case DUAL:
+			bufferL[iw] = lpf.processSampleL(inL) + delayL * feedback;
+			bufferR[iw] = lpf.processSampleR(inR) + delayR * feedback;
+			break;
+
+		case CROSSOVER:
+			bufferL[iw] = lpf.processSampleL(inL) + delayR * feedback;
+			bufferR[iw] = lpf.processSampleR(inR) + delayL * feedback;
+			break;
+
+		case PINGPONG:
+			inL = inR = (inL + inR) * 0.5f;
+			bufferL[iw] = lpf.processSampleL(inL) + delayR * feedback;
+			bufferR[iw] = delayL;
+			break;
+
+		default:
+			assert(0);
+			break;
+		}
 
-			float delayL = bufferL[indexDL];
-			float delayR = bufferR[indexDR];
+		blockL[i] = inL * dry + delayL * wet;
+		blockR[i] = inR * dry + delayR * wet;
 
-			bufferL[index] = lpf.processSampleL(inL) + delayR * feedback;
-			bufferR[index] = lpf.processSampleR(inR) + delayL * feedback;
+		iw = (iw + 1) & bufferMask;
+		iL = (iL + 1) & bufferMask;
+		iR = (iR + 1) & bufferMask;
+	}
+}
 
-			blockL[i] = inL * dry + delayL * wet;
-			blockR[i] = inR * dry + delayR * wet;
+void AudioEffectDreamDelay::processSpan(float *blockL, float *blockR, int len)
+{
+	uint32_t n = static_cast<uint32_t>(len);
 
-			indexDL = (indexDL + 1) % bufferSize;
-			indexDR = (indexDR + 1) % bufferSize;
-			index = (index + 1) % bufferSize;
-		}
+	const float *delayL = bufferL + indexDL;
+	const float *delayR = bufferR + indexDR;
+	float *writeL = bufferL + index;
+	float *writeR = bufferR + index;
+
+	switch (mode)
+	{
+	case DUAL:
+		lpf.processL(blockL, tmpL, len);
+		lpf.processR(blockR, tmpR, len);
+
+		arm_scale_f32(delayL, feedback, writeL, n);
+		arm_scale_f32(delayR, feedback, writeR, n);
+		arm_add_f32(writeL, tmpL, writeL, n);
+		arm_add_f32(writeR, tmpR, writeR, n);
 		break;
 
-	case PINGPONG:
-		for (int i = 0; i < len; i++)
-		{
-			float in = (blockL[i] + blockR[i]) / 2;
+	case CROSSOVER:
+		lpf.processL(blockL, tmpL, len);
+		lpf.processR(blockR, tmpR, len);
 
-			float delayL = bufferL[indexDL];
-			float delayR = bufferR[indexDR];
+		arm_scale_f32(delayR, feedback, writeL, n);
+		arm_scale_f32(delayL, feedback, writeR, n);
+		arm_add_f32(writeL, tmpL, writeL, n);
+		arm_add_f32(writeR, tmpR, writeR, n);
+		break;
 
-			bufferL[index] = lpf.processSampleL(in) + delayR * feedback;
-			bufferR[index] = delayL;
+	case PINGPONG:
+		arm_add_f32(blockL, blockR, blockL, n);
+		arm_scale_f32(blockL, 0.5f, blockL, n);
+		arm_copy_f32(blockL, blockR, n);
 
-			blockL[i] = in * dry + delayL * wet;
-			blockR[i] = in * dry + delayR * wet;
+		lpf.processL(blockL, tmpL, len);
 
-			indexDL = (indexDL + 1) % bufferSize;
-			indexDR = (indexDR + 1) % bufferSize;
-			index = (index + 1) % bufferSize;
-		}
+		arm_scale_f32(delayR, feedback, writeL, n);
+		arm_add_f32(writeL, tmpL, writeL, n);
+		arm_copy_f32(delayL, writeR, n);
 		break;
 
 	default:
 		assert(0);
 		break;
 	}
+
+	arm_scale_f32(delayL, wet, tmpL, n);
+	arm_scale_f32(delayR, wet, tmpR, n);
+	arm_scale_f32(blockL, dry, blockL, n);
+	arm_scale_f32(blockR, dry, blockR, n);
+	arm_add_f32(blockL, tmpL, blockL, n);
+	arm_add_f32(blockR, tmpR, blockR, n);
 }
 
 void AudioEffectDreamDelay::resetState()
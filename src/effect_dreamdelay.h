@@ -53,6 +53,10 @@ public:
 	float getHighCut() { return lpf.getCutoff_Hz(); }
 	int getTempo() { return tempo; }
 	float getMix() { return mix; }
+	float getWet() { return wet; }
+
+	// frames of silent input, after which no echo can follow
+	int getTailFrames() { return maxDelay; }
 
 	void process(float *blockL, float *blockR, int len);
 
@@ -61,17 +65,28 @@ public:
 	std::atomic<bool> bypass;
 
 private:
+	static constexpr int ChunkSize = 64;
+	static constexpr int MinSpan = 8; // shorter spans use the scalar loop
+
+	void processSamples(float *blockL, float *blockR, int len);
+	void processSpan(float *blockL, float *blockR, int len);
+
 	float samplerate;
 
 	Mode mode;
 
-	int bufferSize;
+	int maxDelay;
+	int bufferSize; // power of two
+	int bufferMask;
 	float *bufferL;
 	float *bufferR;
 	int index;
 	int indexDL;
 	int indexDR;
 
+	float tmpL[ChunkSize];
+	float tmpR[ChunkSize];
+
 	float timeL; // Left delay time in seconds
 	float timeR; // Right delay time in seconds
 	Sync timeLSync;
@@ -63,11 +63,18 @@ public:
 
 	void process(float *blockL, float *blockR, int len)
 	{
-		for (int i = 0; i < len; i++)
-		{
-			blockL[i] = processSample(blockL[i], &stateL);
-			blockR[i] = processSample(blockR[i], &stateR);
-		}
+		processBlock(blockL, blockL, len, &stateL);
+		processBlock(blockR, blockR, len, &stateR);
+	}
+
+	void processL(const float *input, float *output, int len)
+	{
+		processBlock(input, output, len, &stateL);
+	}
+
+	void processR(const float *input, float *output, int len)
+	{
+		processBlock(input, output, len, &stateR);
 	}
 
 	void resetState()
@@ -123,6 +130,47 @@ private:
 		return y4;
 	}
 
+	// same as processSample, the state is kept in registers during the block
+	void processBlock(const float *input, float *output, int len, LPFState *state)
+	{
+		float y1 = state->y1;
+		float y2 = state->y2;
+		float y3 = state->y3;
+		float y4 = state->y4;
+		float oldx = state->oldx;
+		float oldy1 = state->oldy1;
+		float oldy2 = state->oldy2;
+		float oldy3 = state->oldy3;
+
+		for (int i = 0; i < len; i++)
+		{
+			float x = input[i] - r * y4;
+
+			y1 = x * p + oldx * p - k * y1;
+			y2 = y1 * p + oldy1 * p - k * y2;
+			y3 = y2 * p + oldy2 * p - k * y3;
+			y4 = y3 * p + oldy3 * p - k * y4;
+
+			y4 -= (y4 * y4 * y4) / 6.0;
+
+			oldx = x;
+			oldy1 = y1;
+			oldy2 = y2;
+			oldy3 = y3;
+
+			output[i] = y4;
+		}
+
+		state->y1 = y1;
+		state->y2 = y2;
+		state->y3 = y3;
+		state->y4 = y4;
+		state->oldx = oldx;
+		state->oldy1 = oldy1;
+		state->oldy2 = oldy2;
+		state->oldy3 = oldy3;
+	}
+
 	float samplerate;
 	float cutoff;
 	float resonance;
@@ -9,6 +9,9 @@
 #include <dsp/support_functions.h>
 #include <dsp/basic_math_functions.h>
 
+#include "arm/arm_mix_stereo_f32.h"
+#include "arm/arm_mix_stereo_ramp_f32.h"
+#include "arm/arm_scale_ramp_f32.h"
 #include "common.h"
 
 #define UNITY_GAIN 1.0f
@@ -29,24 +32,7 @@ float ramp,
 float *pDst,
 int blockSize)
 {
-	int blkCnt; /* Loop counter */
-	float scale = *pScale;
-
-	blkCnt = blockSize;
-
-	while (blkCnt > 0)
-	{
-		if (scale != dScale)
-		{
-			scale = dScale > scale ? fmin(dScale, scale + ramp) : fmax(dScale, scale - ramp);
-		}
-
-		*pDst++ = *pSrc++ * scale;
-
-		blkCnt--;
-	}
-
-	*pScale = scale;
+	*pScale = arm_scale_ramp_f32(pSrc, *pScale, dScale, ramp, pDst, blockSize);
 }
 
 template <int NN>
@@ -54,17 +40,14 @@ class AudioMixer
 {
 public:
 	AudioMixer(int len, float samplerate) :
-	buffer_length{len},
-	sumbufL{new float[buffer_length]{}},
-	ramp{10.0f / samplerate} // 100ms
+	AudioMixer{len, samplerate, true}
 	{
-		for (int i = 0; i < NN; i++)
-			multiplier[i] = UNITY_GAIN;
 	}
 
 	~AudioMixer()
 	{
 		delete[] sumbufL;
+		delete[] tmpbuf;
 	}
 
 	void doAddMix(int channel, float *in)
@@ -74,9 +57,9 @@ public:
 
 		if (multiplier[channel] != UNITY_GAIN)
 		{
-			float tmp[buffer_length];
-			arm_scale_f32(in, multiplier[channel], tmp, buffer_length);
-			arm_add_f32(sumbufL, tmp, sumbufL, buffer_length);
+			assert(tmpbuf);
+			arm_scale_f32(in, multiplier[channel], tmpbuf, buffer_length);
+			arm_add_f32(sumbufL, tmpbuf, sumbufL, buffer_length);
 		}
 		else
 		{
@@ -113,9 +96,21 @@ public:
 	}
 
 protected:
+	// only the mono doAddMix() needs the scratch buffer for scaled inputs
+	AudioMixer(int len, float samplerate, bool scratch) :
+	buffer_length{len},
+	sumbufL{new float[buffer_length]{}},
+	tmpbuf{scratch ? new float[buffer_length]{} : nullptr},
+	ramp{10.0f / samplerate} // 100ms
+	{
+		for (int i = 0; i < NN; i++)
+			multiplier[i] = UNITY_GAIN;
+	}
+
 	float multiplier[NN];
 	int buffer_length;
 	float *sumbufL;
+	float *tmpbuf;
 	const float ramp;
 };
 
@@ -124,7 +119,7 @@ class AudioStereoMixer : public AudioMixer<NN>
 {
 public:
 	AudioStereoMixer(int len, float samplerate) :
-	AudioMixer<NN>{len, samplerate},
+	AudioMixer<NN>{len, samplerate, false},
 	sumbufR{new float[buffer_length]{}}
 	{
 		for (int i = 0; i < NN; i++)
@@ -180,33 +175,16 @@ public:
 		mp_w[channel][1] = multiplier[channel] * panorama[channel][1];
 	}
 
+	// the input is read once for both channels, without a temporary buffer
 	void doAddMix(int channel, float *in)
 	{
 		assert(channel >= 0 && channel < NN);
-
-		float tmp[buffer_length];
-
 		assert(in);
 
-		if (mp[channel][0] != 0.0f || mp_w[channel][0] != 0.0f)
-		{
-			if (mp[channel][0] == mp_w[channel][0])
-				arm_scale_f32(in, mp[channel][0], tmp, buffer_length);
-			else
-				scale_ramp_f32(in, &mp[channel][0], mp_w[channel][0], ramp, tmp, buffer_length);
-
-			arm_add_f32(sumbufL, tmp, sumbufL, buffer_length);
-		}
-
-		if (mp[channel][1] != 0.0f || mp_w[channel][1] != 0.0f)
-		{
-			if (mp[channel][1] == mp_w[channel][1])
-				arm_scale_f32(in, mp[channel][1], tmp, buffer_length);
-			else
-				scale_ramp_f32(in, &mp[channel][1], mp_w[channel][1], ramp, tmp, buffer_length);
-
-			arm_add_f32(sumbufR, tmp, sumbufR, buffer_length);
-		}
+		if (mp[channel][0] != mp_w[channel][0] || mp[channel][1] != mp_w[channel][1])
+			arm_mix_stereo_ramp_f32(in, mp[channel], mp_w[channel], ramp, sumbufL, sumbufR, buffer_length);
+		else if (mp[channel][0] != 0.0f || mp[channel][1] != 0.0f)
+			arm_mix_stereo_f32(in, mp[channel][0], mp[channel][1], sumbufL, sumbufR, buffer_length);
 	}
 
 	void getMix(float *bufferL, float *bufferR)
@@ -100,6 +100,7 @@ public:
 	}
 
 	float get_size() { return rv_time_k; }
+	float get_wet() { return wet; }
 
 	void set_mix(float value)
 	{
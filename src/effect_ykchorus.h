@@ -38,6 +38,7 @@ public:
 	void setChorus2LFORate(float rate) { engine.setChorus2LfoRate(rate); }
 
 	float getMix() { return mix; }
+	float getWet() { return wet; }
 
 	void setMix(float value)
 	{
@@ -0,0 +1,87 @@
+//
+// jobqueue.h
+//
+// MiniDexed - Dexed FM synthesizer for bare metal Raspberry Pi
+// Copyright (C) 2022  The MiniDexed Team
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <atomic>
+#include <cassert>
+
+// Jobs of one audio block, taken by all audio cores.
+// The queue is filled by one core while no other core takes jobs,
+// then it is handed over through the core status handshake.
+
+template <int Size>
+class CJobQueue
+{
+public:
+	CJobQueue() :
+	m_nJobs{},
+	m_nNext{}
+	{
+	}
+
+	void Clear()
+	{
+		m_nJobs = 0;
+		m_nNext.store(0, std::memory_order_relaxed);
+	}
+
+	// the queue is kept sorted by descending cost
+	void Add(int nJob, unsigned nCost)
+	{
+		assert(m_nJobs < Size);
+
+		int i = m_nJobs++;
+		for (; i > 0 && m_Jobs[i - 1].nCost < nCost; --i)
+		{
+			m_Jobs[i] = m_Jobs[i - 1];
+		}
+
+		m_Jobs[i] = {nJob, nCost};
+	}
+
+	// can be called concurrently from all cores
+	bool Get(int *pJob)
+	{
+		int i = m_nNext.fetch_add(1, std::memory_order_relaxed);
+		if (i >= m_nJobs)
+		{
+			return false;
+		}
+
+		*pJob = m_Jobs[i].nJob;
+		return true;
+	}
+
+	int GetCount() const
+	{
+		return m_nJobs;
+	}
+
+private:
+	struct TJob
+	{
+		int nJob;
+		unsigned nCost;
+	};
+
+	TJob m_Jobs[Size];
+	int m_nJobs;
+	std::atomic<int> m_nNext;
+};
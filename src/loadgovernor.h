@@ -0,0 +1,99 @@
+//
+// loadgovernor.h
+//
+// MiniDexed - Dexed FM synthesizer for bare metal Raspberry Pi
+// Copyright (C) 2022  The MiniDexed Team
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#pragma once
+
+// Watches the render time of the audio blocks against their deadline.
+// The level rises by one step, when a block comes close to its deadline,
+// and falls by one step after a period of low load. What is done on each
+// level is up to the user. Only used by core 1.
+
+class CLoadGovernor
+{
+public:
+	static constexpr int MaxLevel = 4;
+
+	CLoadGovernor(unsigned nDeadlineTicks, unsigned nBlocksPerSecond) :
+	m_nHighTicks{nDeadlineTicks / 100 * HighLoad},
+	m_nLowTicks{nDeadlineTicks / 100 * LowLoad},
+	m_nRestoreBlocks{nBlocksPerSecond * RestoreSeconds},
+	m_nLevel{},
+	m_nSettleBlocks{},
+	m_nCalmBlocks{}
+	{
+	}
+
+	// at the end of each block, returns true if the level has changed
+	bool Update(unsigned nBlockTicks)
+	{
+		if (m_nSettleBlocks > 0)
+		{
+			m_nSettleBlocks--;
+		}
+
+		if (nBlockTicks >= m_nHighTicks)
+		{
+			m_nCalmBlocks = 0;
+
+			// give the last step some blocks to take effect
+			if (m_nLevel < MaxLevel && !m_nSettleBlocks)
+			{
+				m_nLevel++;
+				m_nSettleBlocks = SettleBlocks;
+
+				return true;
+			}
+		}
+		else if (nBlockTicks < m_nLowTicks)
+		{
+			if (m_nLevel > 0 && ++m_nCalmBlocks >= m_nRestoreBlocks)
+			{
+				m_nLevel--;
+				m_nCalmBlocks = 0;
+
+				return true;
+			}
+		}
+		else
+		{
+			m_nCalmBlocks = 0;
+		}
+
+		return false;
+	}
+
+	int GetLevel() const
+	{
+		return m_nLevel;
+	}
+
+private:
+	static constexpr unsigned HighLoad = 90; // % of the deadline
+	static constexpr unsigned LowLoad = 60;
+	static constexpr unsigned SettleBlocks = 4;
+	static constexpr unsigned RestoreSeconds = 2;
+
+	unsigned m_nHighTicks;
+	unsigned m_nLowTicks;
+	unsigned m_nRestoreBlocks;
+
+	int m_nLevel;
+	unsigned m_nSettleBlocks;
+	unsigned m_nCalmBlocks;
+};
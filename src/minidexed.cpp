@@ -52,8 +52,9 @@
 #include <wlan/hostap/wpa_supplicant/wpasupplicant.h>
 
 #include "arm/arm_float_to_q23.h"
-#include "arm/arm_scale_zip_f32.h"
-#include "arm/arm_zip_f32.h"
+#include "arm/arm_scale_ramp_f32.h"
+#include "arm/arm_scale_interleave_q23.h"
+#include "arm/arm_scale_ramp_zip_q23.h"
 #include "bus.h"
 #include "common.h"
 #include "config.h"
@@ -82,6 +83,8 @@ const char WLANConfigFile[] = "wpa_supplicant.conf";
 
 LOGMODULE("minidexed");
 
+static_assert(CConfig::MinRenderQuantum % _N_ == 0, "Blocks must hold whole Dexed steps");
+
 CMiniDexed::CMiniDexed(CConfig *pConfig, CInterruptSystem *pInterrupt,
 		       CGPIOManager *pGPIOManager, CI2CMaster *pI2CMaster, CSPIMaster *pSPIMaster, FATFS *pFileSystem) :
 #ifdef ARM_ALLOW_MULTI_CORE
@@ -101,17 +104,43 @@ m_fBusGain{},
 m_SDFilter{},
 m_bUseSerial{},
 m_bQuadDAC8Chan{},
+m_bQuadDACBuses{},
 m_pSoundDevice{},
+m_pOutputBuffer{},
+#ifndef ARM_ALLOW_MULTI_CORE
+m_pSampleBuffer{},
+#endif
 m_bChannelsSwapped{pConfig->GetChannelsSwapped()},
+m_nClockTicks{},
+m_nClockFrames{},
 #ifdef ARM_ALLOW_MULTI_CORE
 // m_nActiveTGsLog2{0},
+m_nBlockTicks{},
+m_nRenderFrames{static_cast<int>(pConfig->GetRenderQuantum())},
+m_nQueueFillFrames{},
+m_bTGRendered{},
+m_OutputLevel{},
+m_bPipelined{pConfig->GetAudioPipeline()},
+m_nRenderBuffer{},
+// pipelined, the first block mixes the cleared buffer 1, where no TG was rendered
+m_nMixBuffer{m_bPipelined ? 1 : 0},
+m_bLoadGovernor{pConfig->GetLoadGovernor()},
+m_LoadGovernor{static_cast<unsigned>(static_cast<uint64_t>(CLOCKHZ) * pConfig->GetRenderQuantum() / pConfig->GetSampleRate()),
+	       pConfig->GetSampleRate() / pConfig->GetRenderQuantum()},
+m_nLoadLevel{},
+m_nLoggedLoadLevel{},
 #endif
 m_nLastKeyDown{},
-m_GetChunkTimer{"GetChunk", 1000000 * pConfig->GetChunkSize() / 2 / pConfig->GetSampleRate()},
+m_GetChunkTimer{"GetChunk", 1000000 * pConfig->GetRenderQuantum() / pConfig->GetSampleRate()},
 m_bProfileEnabled{m_pConfig->GetProfileEnabled()},
+m_Profiler{m_bProfileEnabled, 1000000 * pConfig->GetRenderQuantum() / pConfig->GetSampleRate()},
+m_pFXPool{},
 fx_chain{},
 bus_mixer{},
 sendfx_mixer{},
+m_FXParameterPending{},
+m_bFXResetPending{},
+m_nFXBlocks{},
 m_pNet{},
 m_pNetDevice{},
 m_WLAN{},
@@ -268,15 +297,23 @@ m_fRamp{10.0f / pConfig->GetSampleRate()}
 #if RASPPI == 5
 		// Quad DAC 8-channel mono only an option for RPI 5
 		m_bQuadDAC8Chan = pConfig->GetQuadDAC8Chan();
+		m_bQuadDACBuses = m_bQuadDAC8Chan && pConfig->GetQuadDAC8ChanBuses();
 #endif
-		if (m_bQuadDAC8Chan && (m_nToneGenerators != 8))
+		if (m_bQuadDAC8Chan && !m_bQuadDACBuses && (m_nToneGenerators != 8))
 		{
 			LOGNOTE("ERROR: Quad DAC Mode is only valid when number of TGs = 8.  Defaulting to non-Quad DAC mode,");
 			m_bQuadDAC8Chan = false;
 		}
-		if (m_bQuadDAC8Chan)
+		if (m_bQuadDACBuses)
+		{
+			LOGNOTE("Configured for Quad DAC 8-channel audio, one stereo pair per bus");
+		}
+		else if (m_bQuadDAC8Chan)
 		{
 			LOGNOTE("Configured for Quad DAC 8-channel Mono audio");
+		}
+		if (m_bQuadDAC8Chan)
+		{
 			m_pSoundDevice = new CI2SSoundBaseDevice(pInterrupt, pConfig->GetSampleRate(),
 								 pConfig->GetChunkSize(), false,
 								 pI2CMaster, pConfig->GetDACI2CAddress(),
@@ -318,9 +355,36 @@ m_fRamp{10.0f / pConfig->GetSampleRate()}
 	}
 #endif
 
+	// the buffers of one audio block
+	unsigned nBlockFrames = pConfig->GetRenderQuantum();
+#ifdef ARM_ALLOW_MULTI_CORE
+	m_AudioArena.Reserve<float>(nBlockFrames, 2 * CConfig::AllToneGenerators);
+	m_AudioArena.Reserve<int32_t>(nBlockFrames * 8); // up to 8 channels
+#else
+	// a single core renders all free frames of the queue (two chunks)
+	m_AudioArena.Reserve<float>(2 * pConfig->GetChunkSize());
+	m_AudioArena.Reserve<int32_t>(2 * pConfig->GetChunkSize());
+#endif
+	m_AudioArena.Reserve<float>(2 * nBlockFrames, CConfig::FXChains); // FX crossfade
+	m_AudioArena.Allocate();
+
+#ifdef ARM_ALLOW_MULTI_CORE
+	for (int nBuffer = 0; nBuffer < 2; nBuffer++)
+	{
+		for (int nTG = 0; nTG < CConfig::AllToneGenerators; nTG++)
+		{
+			m_OutputLevel[nBuffer][nTG] = m_AudioArena.Take<float>(nBlockFrames);
+		}
+	}
+	m_pOutputBuffer = m_AudioArena.Take<int32_t>(nBlockFrames * 8);
+#else
+	m_pSampleBuffer = m_AudioArena.Take<float>(2 * pConfig->GetChunkSize());
+	m_pOutputBuffer = m_AudioArena.Take<int32_t>(2 * pConfig->GetChunkSize());
+#endif
+
 	for (int nBus = 0; nBus < CConfig::Buses; ++nBus)
 	{
-		bus_mixer[nBus] = new AudioStereoMixer<CConfig::AllToneGenerators>(pConfig->GetChunkSize() / 2, pConfig->GetSampleRate());
+		bus_mixer[nBus] = new AudioStereoMixer<CConfig::AllToneGenerators>(pConfig->GetRenderQuantum(), pConfig->GetSampleRate());
 
 		for (int nParam = 0; nParam < Bus::Parameter::Unknown; ++nParam)
 		{
@@ -332,12 +396,15 @@ m_fRamp{10.0f / pConfig->GetSampleRate()}
 
 	for (int nMX = 0; nMX < CConfig::FXMixers; nMX++)
 	{
-		sendfx_mixer[nMX] = new AudioStereoMixer<CConfig::AllToneGenerators>(pConfig->GetChunkSize() / 2, pConfig->GetSampleRate());
+		sendfx_mixer[nMX] = new AudioStereoMixer<CConfig::AllToneGenerators>(pConfig->GetRenderQuantum(), pConfig->GetSampleRate());
 	}
 
+	m_pFXPool = new AudioFXPool(pConfig->GetSampleRate());
+
 	for (int nFX = 0; nFX < CConfig::FXChains; nFX++)
 	{
-		fx_chain[nFX] = new AudioFXChain(pConfig->GetSampleRate());
+		fx_chain[nFX] = new AudioFXChain(m_pFXPool, &m_Profiler, CAudioProfiler::FXStage + nFX * FX::slots_num,
+						 m_AudioArena.Take<float>(2 * nBlockFrames), static_cast<int>(nBlockFrames));
 
 		for (int nParam = 0; nParam < FX::Parameter::Unknown; ++nParam)
 		{
@@ -479,6 +546,20 @@ bool CMiniDexed::Initialize()
 
 	m_nQueueSizeFrames = static_cast<int>(m_pSoundDevice->GetQueueSizeFrames());
 
+#ifdef ARM_ALLOW_MULTI_CORE
+	// keep one chunk for the next DMA transfer and one block ahead queued
+	if (m_nRenderFrames > m_nQueueSizeFrames / 2)
+	{
+		LOGERR("RenderQuantum %d exceeds one chunk (%d frames)", m_nRenderFrames, m_nQueueSizeFrames / 2);
+
+		return false;
+	}
+	m_nQueueFillFrames = m_nQueueSizeFrames / 2 + m_nRenderFrames;
+
+	// core 1 sleeps until the queue gets half empty
+	m_pSoundDevice->RegisterNeedDataCallback(SoundNeedDataHandler, this);
+#endif
+
 	m_pSoundDevice->Start();
 
 	m_UI.LoadDefaultScreen();
@@ -581,7 +662,7 @@ void CMiniDexed::Process(bool bPlugAndPlayUpdated)
 
 		for (int nFX = 0; nFX < CConfig::FXChains; ++nFX)
 		{
-			fx_chain[nFX]->resetState();
+			m_bFXResetPending[nFX] = true;
 		}
 
 		if (m_nSetNewPerformanceID == GetActualPerformanceID())
@@ -617,7 +698,7 @@ void CMiniDexed::Process(bool bPlugAndPlayUpdated)
 				for (int idFX = 0; idFX < CConfig::BusFXChains; ++idFX)
 				{
 					int nFX = idFX + nBus * CConfig::BusFXChains;
-					fx_chain[nFX]->resetState();
+					m_bFXResetPending[nFX] = true;
 				}
 
 				nPerfID = m_nBusParameter[nBus][Bus::Parameter::Performance];
@@ -641,9 +722,21 @@ void CMiniDexed::Process(bool bPlugAndPlayUpdated)
 		m_bDeletePerformance = false;
 	}
 
+	UpdateFXEffects();
+
+#ifdef ARM_ALLOW_MULTI_CORE
+	int nLoadLevel = m_nLoadLevel.load(std::memory_order_relaxed);
+	if (nLoadLevel != m_nLoggedLoadLevel)
+	{
+		LOGNOTE("Load level %d", nLoadLevel);
+		m_nLoggedLoadLevel = nLoadLevel;
+	}
+#endif
+
 	if (m_bProfileEnabled)
 	{
 		m_GetChunkTimer.Dump();
+		m_Profiler.Dump();
 	}
 
 	m_Status.Update();
@@ -658,6 +751,51 @@ void CMiniDexed::Process(bool bPlugAndPlayUpdated)
 
 #ifdef ARM_ALLOW_MULTI_CORE
 
+// Let the generic timer wake up this core from WFE at least every nMicros,
+// so that it can never sleep forever, if a wakeup gets lost. WaitForEvent()
+// of the host build has a timeout of its own.
+static void EnableTimerEventStream(unsigned nMicros)
+{
+#ifndef HOST_BUILD
+#ifdef __aarch64__
+	uint64_t nFreq;
+	asm volatile("mrs %0, cntfrq_el0" : "=r"(nFreq));
+#else
+	uint32_t nFreq;
+	asm volatile("mrc p15, 0, %0, c14, c0, 0" : "=r"(nFreq));
+#endif
+
+	// an event is generated on every rising edge of the selected counter bit
+	uint64_t nTicks = static_cast<uint64_t>(nFreq) * nMicros / 1000000;
+	unsigned nBit = 0;
+	while (nBit < 15 && (2ULL << (nBit + 1)) <= nTicks)
+	{
+		nBit++;
+	}
+
+#ifdef __aarch64__
+	uint64_t nCtl;
+	asm volatile("mrs %0, cntkctl_el1" : "=r"(nCtl));
+	nCtl = (nCtl & ~0xF0ULL) | (nBit << 4) | (1 << 2); // EVNTI, EVNTEN
+	asm volatile("msr cntkctl_el1, %0" : : "r"(nCtl));
+#else
+	uint32_t nCtl;
+	asm volatile("mrc p15, 0, %0, c14, c1, 0" : "=r"(nCtl));
+	nCtl = (nCtl & ~0xF0U) | (nBit << 4) | (1 << 2); // EVNTI, EVNTEN
+	asm volatile("mcr p15, 0, %0, c14, c1, 0" : : "r"(nCtl));
+#endif
+#endif
+}
+
+void CMiniDexed::SoundNeedDataHandler(void *pParam)
+{
+	CMiniDexed *pThis = static_cast<CMiniDexed *>(pParam);
+	assert(pThis);
+
+	// called from the sound interrupt on core 0
+	pThis->SendIPI(1, IPI_USER);
+}
+
 void CMiniDexed::Run(unsigned nCore)
 {
 	assert(1 <= nCore && nCore < CORES);
@@ -675,9 +813,15 @@ void CMiniDexed::Run(unsigned nCore)
 			}
 		}
 
+		EnableTimerEventStream(100);
+
+		// sleep between blocks, woken up by the sound interrupt
 		while (m_CoreStatus[nCore] != CoreStatusExit)
 		{
-			ProcessSound();
+			if (!ProcessSound())
+			{
+				WaitForEvent();
+			}
 		}
 	}
 	else // core 2 and 3
@@ -703,23 +847,201 @@ void CMiniDexed::Run(unsigned nCore)
 
 			assert(m_CoreStatus[nCore] == CoreStatusBusy);
 
-			// process the TGs, assigned to this core (2 or 3)
+			ProcessJobs();
+		}
+	}
+}
+
+void CMiniDexed::ProcessJobs()
+{
+	int nJob;
+	while (m_Jobs.Get(&nJob))
+	{
+		RunJob(nJob);
+	}
+}
 
-			assert(m_nFramesToProcess <= m_pConfig->MaxChunkSize);
-			int nTG = m_pConfig->GetTGsCore1() + (static_cast<int>(nCore) - 2) * m_pConfig->GetTGsCore23();
-			for (int i = 0; i < m_pConfig->GetTGsCore23(); i++, nTG++)
-			{
-				assert(nTG < CConfig::AllToneGenerators);
-				if (nTG < m_pConfig->GetToneGenerators())
-				{
-					assert(m_pTG[nTG]);
-					m_pTG[nTG]->getSamples(m_OutputLevel[nTG], m_nFramesToProcess);
-				}
-			}
+void CMiniDexed::DispatchJobs()
+{
+	if (!m_Jobs.GetCount())
+	{
+		return;
+	}
+
+	// kick secondary cores
+	for (unsigned nCore = 2; nCore < CORES; nCore++)
+	{
+		assert(m_CoreStatus[nCore] == CoreStatusIdle);
+		m_CoreStatus[nCore] = CoreStatusBusy;
+		SendIPI(nCore, IPI_USER);
+	}
+
+	// core 1 takes jobs too, until the queue is empty
+	ProcessJobs();
+
+	// wait for cores 2 and 3 to complete their work
+	for (int nCore = 2; nCore < CORES; nCore++)
+	{
+		while (m_CoreStatus[nCore] != CoreStatusIdle)
+		{
+			WaitForEvent();
 		}
 	}
 }
 
+void CMiniDexed::RunJob(int nJob)
+{
+	assert(m_nFramesToProcess <= CConfig::MaxChunkSize);
+
+	if (nJob < BusJobs)
+	{
+		assert(nJob < m_nToneGenerators);
+		assert(m_pTG[nJob]);
+
+		unsigned nStartTicks = m_Profiler.Start();
+		m_pTG[nJob]->getSamples(m_OutputLevel[m_nRenderBuffer][nJob], m_nFramesToProcess, m_nBlockTicks);
+		m_Profiler.Stop(CAudioProfiler::TGStage + nJob, nStartTicks);
+	}
+	else if (nJob < FXJobs)
+	{
+		int nBus = nJob - BusJobs;
+
+		unsigned nStartTicks = m_Profiler.Start();
+		bus_mixer[nBus]->zeroFill();
+		MixBus(bus_mixer[nBus], nBus);
+		m_Profiler.Stop(CAudioProfiler::BusStage + nBus, nStartTicks);
+	}
+	else
+	{
+		int nFX = nJob - FXJobs;
+		int nBus = nFX / CConfig::BusFXChains;
+		assert(nFX < CConfig::FXMixers);
+
+		float *FXSendBuffer[2];
+		sendfx_mixer[nFX]->getBuffers(FXSendBuffer);
+		sendfx_mixer[nFX]->zeroFill();
+		MixBus(sendfx_mixer[nFX], nBus);
+
+		ApplyFXParameters(nFX);
+
+		if (!m_nBusParameter[nBus][Bus::Parameter::FXBypass])
+		{
+			fx_chain[nFX]->process(FXSendBuffer[0], FXSendBuffer[1], m_nFramesToProcess);
+		}
+	}
+}
+
+void CMiniDexed::MixBus(AudioStereoMixer<CConfig::AllToneGenerators> *pMixer, int nBus)
+{
+	for (int i = nBus * 8; i < m_nToneGenerators && i < (nBus + 1) * 8; i++)
+	{
+		if (m_bTGRendered[m_nMixBuffer][i])
+		{
+			pMixer->doAddMix(i, m_OutputLevel[m_nMixBuffer][i]);
+		}
+	}
+}
+
+// Level 1 and 2 limit the voices of each TG to 3/4 and 1/2 of the polyphony,
+// a new note fades out the quietest voice above the limit, released voices
+// first. Level 3 and up additionally fade out the most expensive slots of
+// each FX chain, one more per level.
+void CMiniDexed::ApplyLoadLevel(int nLevel)
+{
+	// logged by core 0, logging may block
+	m_nLoadLevel.store(nLevel, std::memory_order_relaxed);
+
+	int nVoiceLimit = 0;
+	if (nLevel >= 2)
+	{
+		nVoiceLimit = std::max(m_nPolyphony / 2, 1);
+	}
+	else if (nLevel >= 1)
+	{
+		nVoiceLimit = std::max(m_nPolyphony * 3 / 4, 1);
+	}
+
+	for (int i = 0; i < m_nToneGenerators; i++)
+	{
+		assert(m_pTG[i]);
+		m_pTG[i]->setVoiceLimit(nVoiceLimit);
+	}
+
+	for (int nFX = 0; nFX < CConfig::FXChains; nFX++)
+	{
+		fx_chain[nFX]->shed_slots(std::max(nLevel - 2, 0));
+	}
+}
+
+// Each bus goes to its own stereo pair of the 8 channels, after its send FX
+// and the bus gain. The master FX chain is not used, the master volume is.
+void CMiniDexed::WriteBusOutputs(int nFrames)
+{
+	const int Channels = 8;
+	static_assert(CConfig::Buses <= Channels / 2, "Too many buses");
+
+	unsigned nStartTicks = m_Profiler.Start();
+
+	if (m_bVolRampedDown)
+	{
+		m_fMasterVolume[0] = m_fMasterVolume[1] = 0.0f;
+	}
+
+	float fVolume = m_fMasterVolume[0];
+	float fTargetVolume = m_bVolRampDownWait || m_bVolRampedDown ? 0.0f : m_fMasterVolumeW;
+
+	const float *ChannelBuffer[Channels] = {};
+	for (int nBus = 0; nBus < CConfig::Buses; ++nBus)
+	{
+		if (!m_bBusRendered[nBus])
+		{
+			continue;
+		}
+
+		float *BusBuffer[2];
+		bus_mixer[nBus]->getBuffers(BusBuffer);
+
+		arm_scale_ramp_f32(BusBuffer[0], fVolume, fTargetVolume, m_fRamp, BusBuffer[0], nFrames);
+		arm_scale_ramp_f32(BusBuffer[1], fVolume, fTargetVolume, m_fRamp, BusBuffer[1], nFrames);
+
+		ChannelBuffer[nBus * 2] = BusBuffer[m_bChannelsSwapped ? 1 : 0];
+		ChannelBuffer[nBus * 2 + 1] = BusBuffer[m_bChannelsSwapped ? 0 : 1];
+	}
+
+	float fStep = nFrames * m_fRamp;
+	fVolume = fTargetVolume > fVolume ? std::min(fVolume + fStep, fTargetVolume) : std::max(fVolume - fStep, fTargetVolume);
+	m_fMasterVolume[0] = m_fMasterVolume[1] = fVolume;
+
+	if (m_bVolRampDownWait && fVolume == 0.0f)
+	{
+		m_bVolRampDownWait = false;
+		m_bVolRampedDown = true;
+	}
+
+	m_Profiler.Stop(CAudioProfiler::MasterStage, nStartTicks);
+
+	nStartTicks = m_Profiler.Start();
+	arm_scale_interleave_q23(ChannelBuffer, Channels, 1.0f, m_pOutputBuffer, nFrames);
+	m_Profiler.Stop(CAudioProfiler::Q23Stage, nStartTicks);
+
+	// Prevent PCM510x analog mute from kicking in
+	for (int nChannel = 0; nChannel < Channels; nChannel++)
+	{
+		if (m_pOutputBuffer[(nFrames - 1) * Channels + nChannel] == 0)
+		{
+			m_pOutputBuffer[(nFrames - 1) * Channels + nChannel]++;
+		}
+	}
+
+	nStartTicks = m_Profiler.Start();
+	int nBytes = nFrames * Channels * ssizeof(int32_t);
+	if (m_pSoundDevice->Write(m_pOutputBuffer, nBytes) != nBytes)
+	{
+		LOGERR("Sound data dropped");
+	}
+	m_Profiler.Stop(CAudioProfiler::WriteStage, nStartTicks);
+}
+
 #endif
 
 CSysExFileLoader *CMiniDexed::GetSysExFileLoader()
@@ -1149,6 +1471,10 @@ void CMiniDexed::keyup(int pitch, int nTG)
 	if (ApplyNoteLimits(&pitch, nTG))
 	{
 		m_pTG[nTG]->keyup(static_cast<uint8_t>(pitch));
+
+		for (int i = 0; i < CConfig::FXChains; ++i)
+			if (zyn::Sympathetic *pSympathetic = GetSympathetic(i, nTG))
+				pSympathetic->noteOff(pitch);
 	}
 }
 
@@ -1164,7 +1490,22 @@ void CMiniDexed::keydown(int pitch, int velocity, int nTG)
 	if (ApplyNoteLimits(&pitch, nTG))
 	{
 		m_pTG[nTG]->keydown(static_cast<uint8_t>(pitch), static_cast<uint8_t>(velocity));
+
+		for (int i = 0; i < CConfig::FXChains; ++i)
+			if (zyn::Sympathetic *pSympathetic = GetSympathetic(i, nTG))
+				pSympathetic->noteOn(pitch);
+	}
+}
+
+// the Sympathetic effect of an FX chain, if the TG is mixed into the chain
+zyn::Sympathetic *CMiniDexed::GetSympathetic(int nFX, int nTG)
+{
+	if (nFX != CConfig::MasterFX && nFX / CConfig::BusFXChains != nTG / 8)
+	{
+		return nullptr;
 	}
+
+	return fx_chain[nFX]->get_effects().zyn_sympathetic;
 }
 
 bool CMiniDexed::ApplyNoteLimits(int *pitch, int nTG)
@@ -1198,7 +1539,8 @@ void CMiniDexed::setSustain(bool sustain, int nTG)
 
 	// TODO: use the bus MIDI channel for sustain
 	for (int i = 0; i < CConfig::FXChains; ++i)
-		fx_chain[i]->zyn_sympathetic.sustain(sustain);
+		if (zyn::Sympathetic *pSympathetic = fx_chain[i]->get_effects().zyn_sympathetic)
+			pSympathetic->sustain(sustain);
 }
 
 void CMiniDexed::setSostenuto(bool sostenuto, int nTG)
@@ -1228,6 +1570,10 @@ void CMiniDexed::panic(int value, int nTG)
 	if (value == 0)
 	{
 		m_pTG[nTG]->panic();
+
+		for (int i = 0; i < CConfig::FXChains; ++i)
+			if (zyn::Sympathetic *pSympathetic = GetSympathetic(i, nTG))
+				pSympathetic->allNotesOff();
 	}
 }
 
@@ -1240,6 +1586,10 @@ void CMiniDexed::notesOff(int value, int nTG)
 	if (value == 0)
 	{
 		m_pTG[nTG]->notesOff();
+
+		for (int i = 0; i < CConfig::FXChains; ++i)
+			if (zyn::Sympathetic *pSympathetic = GetSympathetic(i, nTG))
+				pSympathetic->allNotesOff();
 	}
 }
 
@@ -1348,6 +1698,248 @@ void CMiniDexed::SetFXParameter(FX::Parameter Parameter, int nValue, int nFX, bo
 
 	if (bSaveOnly) return;
 
+	switch (Parameter)
+	{
+	case FX::Parameter::Slot0:
+	case FX::Parameter::Slot1:
+	case FX::Parameter::Slot2:
+		// the effect is created and set up before the slot selects it
+		if (nValue)
+		{
+			SelectFXEffect(nValue, nFX);
+		}
+		SetFXParameterPending(Parameter, nFX);
+		UnselectFXEffects(nFX);
+		break;
+
+	case FX::Parameter::ZynDistortionPreset:
+	case FX::Parameter::ZynChorusPreset:
+	case FX::Parameter::ZynSympatheticPreset:
+	case FX::Parameter::ZynAPhaserPreset:
+	case FX::Parameter::ZynPhaserPreset:
+	{
+		// the preset is loaded by the effect, which is created for it if needed
+		int nEffectID = FX::getEffectID(Parameter);
+		SelectFXEffect(nEffectID, nFX);
+
+		// former changes must not override the preset
+		for (int nParam = Parameter + 1; nParam < FX::s_effects[nEffectID].MaxID; ++nParam)
+		{
+			m_FXParameterPending[nFX][nParam / 32].fetch_and(~(1u << (nParam % 32)), std::memory_order_relaxed);
+		}
+
+		if (Parameter == FX::Parameter::ZynDistortionPreset)
+		{
+			fx_chain[nFX]->get_effects().zyn_distortion->preparepreset(nValue);
+		}
+		else if (Parameter == FX::Parameter::ZynSympatheticPreset)
+		{
+			fx_chain[nFX]->get_effects().zyn_sympathetic->preparepreset(nValue);
+		}
+
+		SetFXParameterPending(Parameter, nFX);
+		UnselectFXEffects(nFX);
+	}
+	break;
+
+	case FX::Parameter::CloudSeed2Preset:
+		// the engine loads the preset only while processed, so the parameters are taken from the preset here
+		for (int nParam = FX::Parameter::CloudSeed2Interpolation; nParam <= FX::Parameter::CloudSeed2SeedPostDiffusion; ++nParam)
+		{
+			const FX::ParameterType &q = FX::s_Parameter[nParam];
+			m_nFXParameter[nFX][nParam] = mapfloat(AudioEffectCloudSeed2::Presets[nValue][nParam - FX::Parameter::CloudSeed2Interpolation], 0.0f, 1.0f, q.Minimum, q.Maximum);
+			m_FXParameterPending[nFX][nParam / 32].fetch_and(~(1u << (nParam % 32)), std::memory_order_relaxed);
+		}
+
+		SetFXParameterPending(Parameter, nFX);
+		break;
+
+	case FX::Parameter::DreamDelayTime:
+		SetFXParameter(FX::Parameter::DreamDelayTimeL, nValue, nFX);
+		SetFXParameter(FX::Parameter::DreamDelayTimeR, nValue, nFX);
+		break;
+
+	case FX::Parameter::ReturnLevel:
+		fx_chain[nFX]->set_level(powf(nValue / 99.0f, 2));
+		break;
+
+	case FX::Parameter::Bypass:
+		fx_chain[nFX]->bypass = nValue;
+		break;
+
+	case FX::Parameter::ZynDistortionDrive:
+	case FX::Parameter::ZynDistortionType:
+	case FX::Parameter::ZynDistortionShape:
+	case FX::Parameter::ZynDistortionOffset:
+		// the shaper table is built here, before the change is pending
+		if (zyn::Distortion *pDistortion = fx_chain[nFX]->get_effects().zyn_distortion)
+		{
+			pDistortion->prepare(Parameter - FX::Parameter::ZynDistortionMix, nValue);
+		}
+		SetFXParameterPending(Parameter, nFX);
+		break;
+
+	case FX::Parameter::ZynSympatheticType:
+	case FX::Parameter::ZynSympatheticUnisonSize:
+	case FX::Parameter::ZynSympatheticUnisonSpread:
+	case FX::Parameter::ZynSympatheticStrings:
+	case FX::Parameter::ZynSympatheticInterval:
+	case FX::Parameter::ZynSympatheticBaseNote:
+		// the delay lines of the strings are allocated here, before the change is pending
+		if (zyn::Sympathetic *pSympathetic = fx_chain[nFX]->get_effects().zyn_sympathetic)
+		{
+			pSympathetic->prepare(Parameter - FX::Parameter::ZynSympatheticMix, nValue);
+		}
+		SetFXParameterPending(Parameter, nFX);
+		break;
+
+	default:
+		// the effect is changed by the core processing the chain, before the next block
+		SetFXParameterPending(Parameter, nFX);
+		break;
+	}
+}
+
+void CMiniDexed::SetFXParameterPending(FX::Parameter Parameter, int nFX)
+{
+	m_FXParameterPending[nFX][Parameter / 32].fetch_or(1u << (Parameter % 32), std::memory_order_release);
+}
+
+bool CMiniDexed::IsFXParameterPending(FX::Parameter Parameter, int nFX) const
+{
+	return m_FXParameterPending[nFX][Parameter / 32].load(std::memory_order_acquire) & (1u << (Parameter % 32));
+}
+
+// Creates the effect from the pool, if not yet done by the chain, and sets all
+// its parameters. Called by core 0 only.
+void CMiniDexed::SelectFXEffect(int nEffectID, int nFX)
+{
+	assert(nEffectID > 0 && nEffectID < FX::effects_num);
+
+	if (!fx_chain[nFX]->select_effect(nEffectID))
+	{
+		return;
+	}
+
+	// the tables and lines of the effect are built here, not by the audio core
+	if (nEffectID == FX::ZynDistortion)
+	{
+		fx_chain[nFX]->get_effects().zyn_distortion->prepare(&m_nFXParameter[nFX][FX::Parameter::ZynDistortionMix]);
+	}
+	else if (nEffectID == FX::ZynSympathetic)
+	{
+		fx_chain[nFX]->get_effects().zyn_sympathetic->prepare(&m_nFXParameter[nFX][FX::Parameter::ZynSympatheticMix]);
+	}
+
+	for (int nParam = FX::s_effects[nEffectID].MinID; nParam <= FX::s_effects[nEffectID].MaxID; ++nParam)
+	{
+		if (!(FX::s_Parameter[nParam].Flags & FX::Flag::Composite))
+		{
+			SetFXParameterPending(FX::Parameter(nParam), nFX);
+		}
+	}
+}
+
+// The effects, which no slot selects, are released some blocks later by UpdateFXEffects().
+// Must be called after the slot change is pending.
+void CMiniDexed::UnselectFXEffects(int nFX)
+{
+	unsigned nBlock = m_nFXBlocks.load(std::memory_order_acquire);
+
+	for (int nEffectID = 1; nEffectID < FX::effects_num; ++nEffectID)
+	{
+		if (m_nFXParameter[nFX][FX::Parameter::Slot0] != nEffectID &&
+		    m_nFXParameter[nFX][FX::Parameter::Slot1] != nEffectID &&
+		    m_nFXParameter[nFX][FX::Parameter::Slot2] != nEffectID)
+		{
+			fx_chain[nFX]->unselect_effect(nEffectID, nBlock);
+		}
+	}
+}
+
+// Gives the unused effects back to the pool. Called by core 0 only.
+void CMiniDexed::UpdateFXEffects()
+{
+	unsigned nBlock = m_nFXBlocks.load(std::memory_order_acquire);
+
+	for (int nFX = 0; nFX < CConfig::FXChains; ++nFX)
+	{
+		for (int nEffectID = 1; nEffectID < FX::effects_num; ++nEffectID)
+		{
+			if (!fx_chain[nFX]->is_unused(nEffectID, nBlock))
+			{
+				continue;
+			}
+
+			// keep the values, which the effect has changed itself by a preset,
+			// CloudSeed2 presets are already taken by SetFXParameter()
+			if (nEffectID != FX::CloudSeed2)
+			{
+				for (int nParam = FX::s_effects[nEffectID].MinID; nParam <= FX::s_effects[nEffectID].MaxID; ++nParam)
+				{
+					if (!(FX::s_Parameter[nParam].Flags & FX::Flag::Composite))
+					{
+						m_nFXParameter[nFX][nParam] = GetFXParameter(FX::Parameter(nParam), nFX);
+					}
+				}
+			}
+
+			fx_chain[nFX]->release_effect(nEffectID, nBlock);
+		}
+
+		fx_chain[nFX]->reclaim_effects(nBlock);
+
+		// the delay lines, which the strings do not use anymore
+		if (zyn::Sympathetic *pSympathetic = fx_chain[nFX]->get_effects().zyn_sympathetic)
+		{
+			pSympathetic->reclaim();
+		}
+	}
+}
+
+// Must only be called by the core, which processes the FX chain,
+// while the chain is not processed.
+void CMiniDexed::ApplyFXParameters(int nFX)
+{
+	assert(nFX < CConfig::FXChains);
+
+	for (int i = 0; i < FXParameterPendingWords; ++i)
+	{
+		if (!m_FXParameterPending[nFX][i].load(std::memory_order_relaxed))
+		{
+			continue;
+		}
+
+		// applied in parameter order, so presets are loaded before single parameters
+		uint32_t nPending = m_FXParameterPending[nFX][i].exchange(0, std::memory_order_acquire);
+		while (nPending)
+		{
+			int nBit = __builtin_ctz(nPending);
+			nPending &= nPending - 1;
+
+			ApplyFXParameter(FX::Parameter(i * 32 + nBit), nFX);
+		}
+	}
+
+	if (m_bFXResetPending[nFX].exchange(false, std::memory_order_acquire))
+	{
+		fx_chain[nFX]->resetState();
+	}
+}
+
+void CMiniDexed::ApplyFXParameter(FX::Parameter Parameter, int nFX)
+{
+	const FX::ParameterType &p = FX::s_Parameter[Parameter];
+	int nValue = m_nFXParameter[nFX][Parameter];
+
+	// the value is set, when the effect is created again
+	const AudioFXChain::Effects fx = fx_chain[nFX]->get_effects();
+	int nEffectID = FX::getEffectID(Parameter);
+	if (nEffectID && !fx.has(nEffectID))
+	{
+		return;
+	}
+
 	switch (Parameter)
 	{
 	case FX::Parameter::Slot0:
@@ -1357,9 +1949,7 @@ void CMiniDexed::SetFXParameter(FX::Parameter Parameter, int nValue, int nFX, bo
 		break;
 
 	case FX::Parameter::ZynDistortionPreset:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_distortion.loadpreset(nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_distortion->loadpreset(nValue);
 		break;
 
 	case FX::Parameter::ZynDistortionMix:
@@ -1375,53 +1965,39 @@ void CMiniDexed::SetFXParameter(FX::Parameter Parameter, int nValue, int nFX, bo
 	case FX::Parameter::ZynDistortionLRCross:
 	case FX::Parameter::ZynDistortionShape:
 	case FX::Parameter::ZynDistortionOffset:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_distortion.changepar(Parameter - FX::Parameter::ZynDistortionMix, nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_distortion->changepar(Parameter - FX::Parameter::ZynDistortionMix, nValue);
 		break;
 
 	case FX::Parameter::ZynDistortionBypass:
-		fx_chain[nFX]->zyn_distortion.bypass = nValue;
+		fx.zyn_distortion->bypass = nValue;
 		break;
 
 	case FX::Parameter::YKChorusMix:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->yk_chorus.setMix(nValue / 100.0f);
-		m_FXSpinLock.Release();
+		fx.yk_chorus->setMix(nValue / 100.0f);
 		break;
 
 	case FX::Parameter::YKChorusEnable1:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->yk_chorus.setChorus1(nValue);
-		m_FXSpinLock.Release();
+		fx.yk_chorus->setChorus1(nValue);
 		break;
 
 	case FX::Parameter::YKChorusEnable2:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->yk_chorus.setChorus2(nValue);
-		m_FXSpinLock.Release();
+		fx.yk_chorus->setChorus2(nValue);
 		break;
 
 	case FX::Parameter::YKChorusLFORate1:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->yk_chorus.setChorus1LFORate(nValue / 100.0f);
-		m_FXSpinLock.Release();
+		fx.yk_chorus->setChorus1LFORate(nValue / 100.0f);
 		break;
 
 	case FX::Parameter::YKChorusLFORate2:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->yk_chorus.setChorus2LFORate(nValue / 100.0f);
-		m_FXSpinLock.Release();
+		fx.yk_chorus->setChorus2LFORate(nValue / 100.0f);
 		break;
 
 	case FX::Parameter::YKChorusBypass:
-		fx_chain[nFX]->yk_chorus.bypass = nValue;
+		fx.yk_chorus->bypass = nValue;
 		break;
 
 	case FX::Parameter::ZynChorusPreset:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_chorus.loadpreset(nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_chorus->loadpreset(nValue);
 		break;
 
 	case FX::Parameter::ZynChorusMix:
@@ -1436,19 +2012,15 @@ void CMiniDexed::SetFXParameter(FX::Parameter Parameter, int nValue, int nFX, bo
 	case FX::Parameter::ZynChorusLRCross:
 	case FX::Parameter::ZynChorusMode:
 	case FX::Parameter::ZynChorusSubtractive:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_chorus.changepar(Parameter - FX::Parameter::ZynChorusMix, nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_chorus->changepar(Parameter - FX::Parameter::ZynChorusMix, nValue);
 		break;
 
 	case FX::Parameter::ZynChorusBypass:
-		fx_chain[nFX]->zyn_chorus.bypass = nValue;
+		fx.zyn_chorus->bypass = nValue;
 		break;
 
 	case FX::Parameter::ZynSympatheticPreset:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_sympathetic.loadpreset(nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_sympathetic->loadpreset(nValue);
 		break;
 
 	case FX::Parameter::ZynSympatheticMix:
@@ -1466,19 +2038,15 @@ void CMiniDexed::SetFXParameter(FX::Parameter Parameter, int nValue, int nFX, bo
 	case FX::Parameter::ZynSympatheticLowcut:
 	case FX::Parameter::ZynSympatheticHighcut:
 	case FX::Parameter::ZynSympatheticNegate:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_sympathetic.changepar(Parameter - FX::Parameter::ZynSympatheticMix, nValue, true);
-		m_FXSpinLock.Release();
+		fx.zyn_sympathetic->changepar(Parameter - FX::Parameter::ZynSympatheticMix, nValue, true);
 		break;
 
 	case FX::Parameter::ZynSympatheticBypass:
-		fx_chain[nFX]->zyn_sympathetic.bypass = nValue;
+		fx.zyn_sympathetic->bypass = nValue;
 		break;
 
 	case FX::Parameter::ZynAPhaserPreset:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_aphaser.loadpreset(nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_aphaser->loadpreset(nValue);
 		break;
 
 	case FX::Parameter::ZynAPhaserMix:
@@ -1496,19 +2064,15 @@ void CMiniDexed::SetFXParameter(FX::Parameter Parameter, int nValue, int nFX, bo
 	case FX::Parameter::ZynAPhaserDistortion:
 	case FX::Parameter::ZynAPhaserMismatch:
 	case FX::Parameter::ZynAPhaserHyper:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_aphaser.changepar(Parameter - FX::Parameter::ZynAPhaserMix, nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_aphaser->changepar(Parameter - FX::Parameter::ZynAPhaserMix, nValue);
 		break;
 
 	case FX::Parameter::ZynAPhaserBypass:
-		fx_chain[nFX]->zyn_aphaser.bypass = nValue;
+		fx.zyn_aphaser->bypass = nValue;
 		break;
 
 	case FX::Parameter::ZynPhaserPreset:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_phaser.loadpreset(nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_phaser->loadpreset(nValue);
 		break;
 
 	case FX::Parameter::ZynPhaserMix:
@@ -1523,128 +2087,95 @@ void CMiniDexed::SetFXParameter(FX::Parameter Parameter, int nValue, int nFX, bo
 	case FX::Parameter::ZynPhaserLRCross:
 	case FX::Parameter::ZynPhaserSubtractive:
 	case FX::Parameter::ZynPhaserPhase:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->zyn_phaser.changepar(Parameter - FX::Parameter::ZynPhaserMix, nValue);
-		m_FXSpinLock.Release();
+		fx.zyn_phaser->changepar(Parameter - FX::Parameter::ZynPhaserMix, nValue);
 		break;
 
 	case FX::Parameter::ZynPhaserBypass:
-		fx_chain[nFX]->zyn_phaser.bypass = nValue;
+		fx.zyn_phaser->bypass = nValue;
 		break;
 
 	case FX::Parameter::DreamDelayMix:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->dream_delay.setMix(nValue / 100.0f);
-		m_FXSpinLock.Release();
+		fx.dream_delay->setMix(nValue / 100.0f);
 		break;
 
 	case FX::Parameter::DreamDelayMode:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->dream_delay.setMode((AudioEffectDreamDelay::Mode)nValue);
-		m_FXSpinLock.Release();
-		break;
-
-	case FX::Parameter::DreamDelayTime:
-		SetFXParameter(FX::Parameter::DreamDelayTimeL, nValue, nFX);
-		SetFXParameter(FX::Parameter::DreamDelayTimeR, nValue, nFX);
+		fx.dream_delay->setMode((AudioEffectDreamDelay::Mode)nValue);
 		break;
 
 	case FX::Parameter::DreamDelayTimeL:
-		m_FXSpinLock.Acquire();
 
 		if (nValue <= 100)
 		{
-			fx_chain[nFX]->dream_delay.setTimeL(nValue / 100.f);
-			fx_chain[nFX]->dream_delay.setTimeLSync(AudioEffectDreamDelay::SYNC_NONE);
+			fx.dream_delay->setTimeL(nValue / 100.f);
+			fx.dream_delay->setTimeLSync(AudioEffectDreamDelay::SYNC_NONE);
 		}
 		else
 		{
-			fx_chain[nFX]->dream_delay.setTimeLSync((AudioEffectDreamDelay::Sync)(nValue - 100));
+			fx.dream_delay->setTimeLSync((AudioEffectDreamDelay::Sync)(nValue - 100));
 		}
 
-		m_FXSpinLock.Release();
 		break;
 
 	case FX::Parameter::DreamDelayTimeR:
-		m_FXSpinLock.Acquire();
 
 		if (nValue <= 100)
 		{
-			fx_chain[nFX]->dream_delay.setTimeR(nValue / 100.f);
-			fx_chain[nFX]->dream_delay.setTimeRSync(AudioEffectDreamDelay::SYNC_NONE);
+			fx.dream_delay->setTimeR(nValue / 100.f);
+			fx.dream_delay->setTimeRSync(AudioEffectDreamDelay::SYNC_NONE);
 		}
 		else
 		{
-			fx_chain[nFX]->dream_delay.setTimeRSync((AudioEffectDreamDelay::Sync)(nValue - 100));
+			fx.dream_delay->setTimeRSync((AudioEffectDreamDelay::Sync)(nValue - 100));
 		}
 
-		m_FXSpinLock.Release();
 		break;
 
 	case FX::Parameter::DreamDelayTempo:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->dream_delay.setTempo(nValue);
-		m_FXSpinLock.Release();
+		fx.dream_delay->setTempo(nValue);
 		break;
 
 	case FX::Parameter::DreamDelayFeedback:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->dream_delay.setFeedback(nValue / 100.0f);
-		m_FXSpinLock.Release();
+		fx.dream_delay->setFeedback(nValue / 100.0f);
 		break;
 
 	case FX::Parameter::DreamDelayHighCut:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->dream_delay.setHighCut(MIDI_EQ_HZ[nValue]);
-		m_FXSpinLock.Release();
+		fx.dream_delay->setHighCut(MIDI_EQ_HZ[nValue]);
 		break;
 
 	case FX::Parameter::DreamDelayBypass:
-		fx_chain[nFX]->dream_delay.bypass = nValue;
+		fx.dream_delay->bypass = nValue;
 		break;
 
 	case FX::Parameter::PlateReverbMix:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->plate_reverb.set_mix(nValue / 100.0f);
-		m_FXSpinLock.Release();
+		fx.plate_reverb->set_mix(nValue / 100.0f);
 		break;
 
 	case FX::Parameter::PlateReverbSize:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->plate_reverb.size(nValue / 99.0f);
-		m_FXSpinLock.Release();
+		fx.plate_reverb->size(nValue / 99.0f);
 		break;
 
 	case FX::Parameter::PlateReverbHighDamp:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->plate_reverb.hidamp(nValue / 99.0f);
-		m_FXSpinLock.Release();
+		fx.plate_reverb->hidamp(nValue / 99.0f);
 		break;
 
 	case FX::Parameter::PlateReverbLowDamp:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->plate_reverb.lodamp(nValue / 99.0f);
-		m_FXSpinLock.Release();
+		fx.plate_reverb->lodamp(nValue / 99.0f);
 		break;
 
 	case FX::Parameter::PlateReverbLowPass:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->plate_reverb.lowpass(nValue / 99.0f);
-		m_FXSpinLock.Release();
+		fx.plate_reverb->lowpass(nValue / 99.0f);
 		break;
 
 	case FX::Parameter::PlateReverbDiffusion:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->plate_reverb.diffusion(nValue / 99.0f);
-		m_FXSpinLock.Release();
+		fx.plate_reverb->diffusion(nValue / 99.0f);
 		break;
 
 	case FX::Parameter::PlateReverbBypass:
-		fx_chain[nFX]->plate_reverb.bypass = nValue;
+		fx.plate_reverb->bypass = nValue;
 		break;
 
 	case FX::Parameter::CloudSeed2Preset:
-		fx_chain[nFX]->cloudseed2.loadPreset(nValue);
+		fx.cloudseed2->loadPreset(nValue);
 		break;
 
 	case FX::Parameter::CloudSeed2Interpolation:
@@ -1692,119 +2223,79 @@ void CMiniDexed::SetFXParameter(FX::Parameter Parameter, int nValue, int nFX, bo
 	case FX::Parameter::CloudSeed2SeedDiffusion:
 	case FX::Parameter::CloudSeed2SeedDelay:
 	case FX::Parameter::CloudSeed2SeedPostDiffusion:
-		fx_chain[nFX]->cloudseed2.setParameter(Parameter - FX::Parameter::CloudSeed2Interpolation, mapfloat(nValue, p.Minimum, p.Maximum, 0.0f, 1.0f));
+		fx.cloudseed2->setParameter(Parameter - FX::Parameter::CloudSeed2Interpolation, mapfloat(nValue, p.Minimum, p.Maximum, 0.0f, 1.0f));
 		break;
 
 	case FX::Parameter::CloudSeed2Bypass:
-		fx_chain[nFX]->cloudseed2.bypass = nValue;
+		fx.cloudseed2->bypass = nValue;
 		break;
 
 	case FX::Parameter::CompressorPreGain:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->compressor.setPreGain_dB(nValue);
-		m_FXSpinLock.Release();
+		fx.compressor->setPreGain_dB(nValue);
 		break;
 
 	case FX::Parameter::CompressorThresh:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->compressor.setThresh_dBFS(nValue);
-		m_FXSpinLock.Release();
+		fx.compressor->setThresh_dBFS(nValue);
 		break;
 
 	case FX::Parameter::CompressorRatio:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->compressor.setCompressionRatio(nValue);
-		m_FXSpinLock.Release();
+		fx.compressor->setCompressionRatio(nValue);
 		break;
 
 	case FX::Parameter::CompressorAttack:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->compressor.setAttack_sec((nValue ?: 1) / 1000.0f);
-		m_FXSpinLock.Release();
+		fx.compressor->setAttack_sec((nValue ?: 1) / 1000.0f);
 		break;
 
 	case FX::Parameter::CompressorRelease:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->compressor.setRelease_sec((nValue ?: 1) / 1000.0f);
-		m_FXSpinLock.Release();
+		fx.compressor->setRelease_sec((nValue ?: 1) / 1000.0f);
 		break;
 
 	case FX::Parameter::CompressorMakeupGain:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->compressor.setMakeupGain_dB(nValue);
-		m_FXSpinLock.Release();
+		fx.compressor->setMakeupGain_dB(nValue);
 		break;
 
 	case FX::Parameter::CompressorHPFilterEnable:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->compressor.enableHPFilter(nValue);
-		m_FXSpinLock.Release();
+		fx.compressor->enableHPFilter(nValue);
 		break;
 
 	case FX::Parameter::CompressorBypass:
-		fx_chain[nFX]->compressor.bypass = nValue;
+		fx.compressor->bypass = nValue;
 		break;
 
 	case FX::Parameter::EQLow:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->eq.setLow_dB(nValue);
-		m_FXSpinLock.Release();
+		fx.eq->setLow_dB(nValue);
 		break;
 
 	case FX::Parameter::EQMid:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->eq.setMid_dB(nValue);
-		m_FXSpinLock.Release();
+		fx.eq->setMid_dB(nValue);
 		break;
 
 	case FX::Parameter::EQHigh:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->eq.setHigh_dB(nValue);
-		m_FXSpinLock.Release();
+		fx.eq->setHigh_dB(nValue);
 		break;
 
 	case FX::Parameter::EQGain:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->eq.setGain_dB(nValue);
-		m_FXSpinLock.Release();
+		fx.eq->setGain_dB(nValue);
 		break;
 
 	case FX::Parameter::EQLowMidFreq:
-		m_FXSpinLock.Acquire();
-		m_nFXParameter[nFX][Parameter] = fx_chain[nFX]->eq.setLowMidFreq_n(nValue);
-		m_FXSpinLock.Release();
+		fx.eq->setLowMidFreq_n(nValue);
 		break;
 
 	case FX::Parameter::EQMidHighFreq:
-		m_FXSpinLock.Acquire();
-		m_nFXParameter[nFX][Parameter] = fx_chain[nFX]->eq.setMidHighFreq_n(nValue);
-		m_FXSpinLock.Release();
+		fx.eq->setMidHighFreq_n(nValue);
 		break;
 
 	case FX::Parameter::EQPreLowCut:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->eq.setPreLowCut(MIDI_EQ_HZ[nValue]);
-		m_FXSpinLock.Release();
+		fx.eq->setPreLowCut(MIDI_EQ_HZ[nValue]);
 		break;
 
 	case FX::Parameter::EQPreHighCut:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->eq.setPreHighCut(MIDI_EQ_HZ[nValue]);
-		m_FXSpinLock.Release();
+		fx.eq->setPreHighCut(MIDI_EQ_HZ[nValue]);
 		break;
 
 	case FX::Parameter::EQBypass:
-		fx_chain[nFX]->eq.bypass = nValue;
-		break;
-
-	case FX::Parameter::ReturnLevel:
-		m_FXSpinLock.Acquire();
-		fx_chain[nFX]->set_level(powf(nValue / 99.0f, 2));
-		m_FXSpinLock.Release();
-		break;
-
-	case FX::Parameter::Bypass:
-		fx_chain[nFX]->bypass = nValue;
+		fx.eq->bypass = nValue;
 		break;
 
 	default:
@@ -1818,35 +2309,60 @@ int CMiniDexed::GetFXParameter(FX::Parameter Parameter, int nFX)
 	assert(nFX < CConfig::FXChains);
 	assert(Parameter < FX::Parameter::Unknown);
 
+	// not yet applied, the effect still has the former value
+	if (IsFXParameterPending(Parameter, nFX))
+	{
+		return m_nFXParameter[nFX][Parameter];
+	}
+
+	// not created, the value is kept until the effect is created again
+	const AudioFXChain::Effects fx = fx_chain[nFX]->get_effects();
+	int nEffectID = FX::getEffectID(Parameter);
+	if (!nEffectID || !fx.has(nEffectID))
+	{
+		return m_nFXParameter[nFX][Parameter];
+	}
+
 	if (Parameter >= FX::Parameter::ZynDistortionMix && Parameter <= FX::Parameter::ZynDistortionOffset)
 	{
-		return fx_chain[nFX]->zyn_distortion.getpar(Parameter - FX::Parameter::ZynDistortionMix);
+		return fx.zyn_distortion->getpar(Parameter - FX::Parameter::ZynDistortionMix);
 	}
 
 	if (Parameter >= FX::Parameter::ZynChorusMix && Parameter <= FX::Parameter::ZynChorusSubtractive)
 	{
-		return fx_chain[nFX]->zyn_chorus.getpar(Parameter - FX::Parameter::ZynChorusMix);
+		return fx.zyn_chorus->getpar(Parameter - FX::Parameter::ZynChorusMix);
 	}
 
 	if (Parameter >= FX::Parameter::ZynSympatheticMix && Parameter <= FX::Parameter::ZynSympatheticNegate)
 	{
-		return fx_chain[nFX]->zyn_sympathetic.getpar(Parameter - FX::Parameter::ZynSympatheticMix);
+		return fx.zyn_sympathetic->getpar(Parameter - FX::Parameter::ZynSympatheticMix);
 	}
 
 	if (Parameter >= FX::Parameter::ZynAPhaserMix && Parameter <= FX::Parameter::ZynAPhaserHyper)
 	{
-		return fx_chain[nFX]->zyn_aphaser.getpar(Parameter - FX::Parameter::ZynAPhaserMix);
+		return fx.zyn_aphaser->getpar(Parameter - FX::Parameter::ZynAPhaserMix);
 	}
 
 	if (Parameter >= FX::Parameter::ZynPhaserMix && Parameter <= FX::Parameter::ZynPhaserPhase)
 	{
-		return fx_chain[nFX]->zyn_phaser.getpar(Parameter - FX::Parameter::ZynPhaserMix);
+		return fx.zyn_phaser->getpar(Parameter - FX::Parameter::ZynPhaserMix);
 	}
 
 	if (Parameter >= FX::Parameter::CloudSeed2Interpolation && Parameter <= FX::Parameter::CloudSeed2SeedPostDiffusion)
 	{
 		const FX::ParameterType &p = FX::s_Parameter[Parameter];
-		return mapfloat(fx_chain[nFX]->cloudseed2.getParameter(Parameter - FX::Parameter::CloudSeed2Interpolation), 0.0f, 1.0f, p.Minimum, p.Maximum);
+		return mapfloat(fx.cloudseed2->getParameter(Parameter - FX::Parameter::CloudSeed2Interpolation), 0.0f, 1.0f, p.Minimum, p.Maximum);
+	}
+
+	// the EQ may limit the frequencies
+	if (Parameter == FX::Parameter::EQLowMidFreq)
+	{
+		return fx.eq->getLowMidFreq_n();
+	}
+
+	if (Parameter == FX::Parameter::EQMidHighFreq)
+	{
+		return fx.eq->getMidHighFreq_n();
 	}
 
 	return m_nFXParameter[nFX][Parameter];
@@ -2375,9 +2891,31 @@ std::string CMiniDexed::GetVoiceName(int nTG)
 	return Result;
 }
 
+// The block time advances by the frames of the blocks, as the sound device
+// takes them, so that the commands keep their distance in the audio. It is
+// taken once per block for all TGs and synchronized again to the clock,
+// if it drifted by more than a block, e.g. after a dropout.
+unsigned CMiniDexed::GetBlockTicks(int nFrames)
+{
+	unsigned nNow = CTimer::GetClockTicks();
+	unsigned nBlockTicks = m_nClockTicks + static_cast<unsigned>(m_nClockFrames * CLOCKHZ / m_pConfig->GetSampleRate());
+	int nMaxDrift = static_cast<int>(static_cast<uint64_t>(nFrames) * CLOCKHZ / m_pConfig->GetSampleRate());
+
+	int nDrift = static_cast<int>(nNow - nBlockTicks);
+	if (m_nClockFrames == 0 || nDrift > nMaxDrift || nDrift < -nMaxDrift)
+	{
+		m_nClockTicks = nNow;
+		m_nClockFrames = 0;
+		nBlockTicks = nNow;
+	}
+
+	m_nClockFrames += static_cast<unsigned>(nFrames);
+	return nBlockTicks;
+}
+
 #ifndef ARM_ALLOW_MULTI_CORE
 
-void CMiniDexed::ProcessSound()
+bool CMiniDexed::ProcessSound()
 {
 	assert(m_pSoundDevice);
 
@@ -2389,38 +2927,66 @@ void CMiniDexed::ProcessSound()
 			m_GetChunkTimer.Start();
 		}
 
-		float32_t SampleBuffer[nFrames];
-		m_pTG[0]->getSamples(SampleBuffer, nFrames);
+		for (int nFX = 0; nFX < CConfig::FXChains; ++nFX)
+		{
+			ApplyFXParameters(nFX);
+		}
+
+		unsigned nBlockTicks = GetBlockTicks(nFrames);
+
+		if (m_pTG[0]->isActive() || m_pTG[0]->hasPendingCommands())
+		{
+			unsigned nStartTicks = m_Profiler.Start();
+			m_pTG[0]->getSamples(m_pSampleBuffer, nFrames, nBlockTicks);
+			m_Profiler.Stop(CAudioProfiler::TGStage, nStartTicks);
+		}
+		else
+		{
+			arm_fill_f32(0.0f, m_pSampleBuffer, static_cast<uint32_t>(nFrames));
+		}
 
 		// Convert single float array (mono) to int16 array
-		int32_t tmp_int[nFrames];
-		arm_float_to_q23(SampleBuffer, tmp_int, nFrames);
+		unsigned nStartTicks = m_Profiler.Start();
+		arm_float_to_q23(m_pSampleBuffer, m_pOutputBuffer, nFrames);
+		m_Profiler.Stop(CAudioProfiler::Q23Stage, nStartTicks);
 
-		if (m_pSoundDevice->Write(tmp_int, sizeof(tmp_int)) != ssizeof(tmp_int))
+		nStartTicks = m_Profiler.Start();
+		int nBytes = nFrames * ssizeof(int32_t);
+		if (m_pSoundDevice->Write(m_pOutputBuffer, nBytes) != nBytes)
 		{
 			LOGERR("Sound data dropped");
 		}
+		m_Profiler.Stop(CAudioProfiler::WriteStage, nStartTicks);
+
+		m_nFXBlocks.fetch_add(1, std::memory_order_release);
+		m_Profiler.EndBlock();
 
 		if (m_bProfileEnabled)
 		{
 			m_GetChunkTimer.Stop();
 		}
+
+		return true;
 	}
+
+	return false;
 }
 
 #else // #ifdef ARM_ALLOW_MULTI_CORE
 
-void CMiniDexed::ProcessSound()
+bool CMiniDexed::ProcessSound()
 {
 	assert(m_pSoundDevice);
 	assert(m_pConfig);
 
-	int nFrames = m_nQueueSizeFrames - static_cast<int>(m_pSoundDevice->GetQueueFramesAvail());
-	if (nFrames >= m_nQueueSizeFrames / 2)
+	int nQueuedFrames = static_cast<int>(m_pSoundDevice->GetQueueFramesAvail());
+	if (nQueuedFrames + m_nRenderFrames <= m_nQueueFillFrames)
 	{
-		// only process the minimum number of frames (== chunksize / 2)
-		// as the tg_mixer cannot process more
-		nFrames = m_nQueueSizeFrames / 2;
+		// always process one block (== RenderQuantum frames),
+		// as the mixers and TG output buffers are sized to it
+		int nFrames = m_nRenderFrames;
+
+		unsigned nBlockStartTicks = CTimer::GetClockTicks();
 
 		if (m_bProfileEnabled)
 		{
@@ -2428,37 +2994,35 @@ void CMiniDexed::ProcessSound()
 		}
 
 		m_nFramesToProcess = nFrames;
+		m_nBlockTicks = GetBlockTicks(nFrames);
 
-		// kick secondary cores
-		for (unsigned nCore = 2; nCore < CORES; nCore++)
-		{
-			assert(m_CoreStatus[nCore] == CoreStatusIdle);
-			m_CoreStatus[nCore] = CoreStatusBusy;
-			SendIPI(nCore, IPI_USER);
-		}
-
-		// process the TGs assigned to core 1
-		assert(nFrames <= CConfig::MaxChunkSize);
-		for (int i = 0; i < m_pConfig->GetTGsCore1(); i++)
+		// queue the active TGs, the most expensive are taken first
+		m_Jobs.Clear();
+		for (int i = 0; i < m_nToneGenerators; i++)
 		{
 			assert(m_pTG[i]);
-			m_pTG[i]->getSamples(m_OutputLevel[i], nFrames);
-		}
 
-		// wait for cores 2 and 3 to complete their work
-		for (int nCore = 2; nCore < CORES; nCore++)
-		{
-			while (m_CoreStatus[nCore] != CoreStatusIdle)
+			// a TG activated by a keydown from now on is rendered in the next block
+			m_bTGRendered[m_nRenderBuffer][i] = m_pTG[i]->isActive() || m_pTG[i]->hasPendingCommands();
+			if (m_bTGRendered[m_nRenderBuffer][i])
 			{
-				WaitForEvent();
+				m_Jobs.Add(i, 1 + static_cast<unsigned>(m_pTG[i]->getActiveVoices()));
 			}
 		}
 
+		// when pipelined, the TGs of the next block are rendered
+		// together with the bus and send FX jobs of this block
+		if (!m_bPipelined)
+		{
+			DispatchJobs();
+			m_Jobs.Clear();
+		}
+
 		//
 		// Audio signal path after tone generators starts here
 		//
 
-		if (m_bQuadDAC8Chan)
+		if (m_bQuadDAC8Chan && !m_bQuadDACBuses)
 		{
 			// This is only supported when there are 8 TGs
 			assert(m_nToneGenerators == 8);
@@ -2466,45 +3030,81 @@ void CMiniDexed::ProcessSound()
 			// No mixing is performed by MiniDexed, sound is output in 8 channels.
 			// Note: one TG per audio channel; output=mono; no processing.
 			const int Channels = 8; // One TG per channel
-			float tmp_float[nFrames * Channels];
-			int32_t tmp_int[nFrames * Channels];
+			for (int nFX = 0; nFX < CConfig::FXChains; ++nFX)
+			{
+				ApplyFXParameters(nFX);
+			}
+
+			DispatchJobs();
 
-			// Convert dual float array (8 chan) to single int16 array (8 chan)
-			for (int i = 0; i < nFrames; i++)
+			// TGs will alternate on L/R channels for each output
+			// reading directly from the TG OutputLevel buffer with
+			// no additional processing.
+			const float *ChannelBuffer[Channels];
+			for (int tg = 0; tg < Channels; tg++)
 			{
-				// TGs will alternate on L/R channels for each output
-				// reading directly from the TG OutputLevel buffer with
-				// no additional processing.
-				for (int tg = 0; tg < Channels; tg++)
-				{
-					tmp_float[(i * Channels) + tg] = m_OutputLevel[tg][i] * m_fMasterVolumeW;
-				}
+				ChannelBuffer[tg] = m_bTGRendered[m_nMixBuffer][tg] ? m_OutputLevel[m_nMixBuffer][tg] : nullptr;
 			}
 
-			arm_float_to_q23(tmp_float, tmp_int, nFrames * Channels);
+			// Scale, interleave and convert to q23 (8 chan) in one pass
+			unsigned nStartTicks = m_Profiler.Start();
+			arm_scale_interleave_q23(ChannelBuffer, Channels, m_fMasterVolumeW, m_pOutputBuffer, nFrames);
+			m_Profiler.Stop(CAudioProfiler::Q23Stage, nStartTicks);
 
 			// Prevent PCM510x analog mute from kicking in
 			for (int tg = 0; tg < Channels; tg++)
 			{
-				if (tmp_int[(nFrames - 1) * Channels + tg] == 0)
+				if (m_pOutputBuffer[(nFrames - 1) * Channels + tg] == 0)
 				{
-					tmp_int[(nFrames - 1) * Channels + tg]++;
+					m_pOutputBuffer[(nFrames - 1) * Channels + tg]++;
 				}
 			}
 
-			if (m_pSoundDevice->Write(tmp_int, sizeof(tmp_int)) != ssizeof(tmp_int))
+			nStartTicks = m_Profiler.Start();
+			int nBytes = nFrames * Channels * ssizeof(int32_t);
+			if (m_pSoundDevice->Write(m_pOutputBuffer, nBytes) != nBytes)
 			{
 				LOGERR("Sound data dropped");
 			}
+			m_Profiler.Stop(CAudioProfiler::WriteStage, nStartTicks);
 		}
 		else
 		{
-			// Mix everything down to stereo
+			// Mix everything down to stereo, or each bus to its own pair of the 8 channels
 			int indexL = 0, indexR = 1;
 
-			// BEGIN TG mixing
-			float tmp_float[nFrames * 2];
-			int32_t tmp_int[nFrames * 2];
+			// queue the bus mixes and the send FX chains, which run in parallel
+			for (int nBus = 0; nBus < CConfig::Buses; ++nBus)
+			{
+				m_bBusRendered[nBus] = m_nToneGenerators > nBus * 8 && m_fBusGain[nBus] != 0.0f;
+
+				if (m_nToneGenerators > nBus * 8 && !m_bBusRendered[nBus])
+				{
+					bus_mixer[nBus]->zeroFill();
+				}
+
+				if (m_bBusRendered[nBus])
+				{
+					m_Jobs.Add(BusJobs + nBus, 1);
+				}
+
+				for (int idFX = 0; idFX < CConfig::BusFXChains; ++idFX)
+				{
+					int nFX = idFX + CConfig::BusFXChains * nBus;
+
+					m_bFXRendered[nFX] = m_bBusRendered[nBus] && fx_chain[nFX]->get_level() != 0.0f;
+					if (m_bFXRendered[nFX])
+					{
+						m_Jobs.Add(FXJobs + nFX, 2 + static_cast<unsigned>(fx_chain[nFX]->get_active_slots()));
+					}
+					else
+					{
+						ApplyFXParameters(nFX);
+					}
+				}
+			}
+
+			DispatchJobs();
 
 			// get the mix buffer of all TGs
 			float *MasterBuffer[2];
@@ -2512,23 +3112,11 @@ void CMiniDexed::ProcessSound()
 
 			for (int nBus = 0; nBus < CConfig::Buses; ++nBus)
 			{
-				if (m_nToneGenerators <= nBus * 8)
+				if (!m_bBusRendered[nBus])
 					continue;
 
 				float *BusBuffer[2];
 				bus_mixer[nBus]->getBuffers(BusBuffer);
-				bus_mixer[nBus]->zeroFill();
-
-				if (m_fBusGain[nBus] == 0.0f)
-					continue;
-
-				for (int i = nBus * 8; i < m_nToneGenerators; i++)
-				{
-					if (i < (nBus + 1) * 8)
-					{
-						bus_mixer[nBus]->doAddMix(i, m_OutputLevel[i]);
-					}
-				}
 
 				// BEGIN adding sendFX
 				float *FXSendBuffer[2];
@@ -2537,25 +3125,9 @@ void CMiniDexed::ProcessSound()
 				{
 					int nFX = idFX + CConfig::BusFXChains * nBus;
 
-					if (fx_chain[nFX]->get_level() == 0.0f) continue;
+					if (!m_bFXRendered[nFX]) continue;
 
 					sendfx_mixer[nFX]->getBuffers(FXSendBuffer);
-					sendfx_mixer[nFX]->zeroFill();
-
-					for (int i = nBus * 8; i < m_nToneGenerators; i++)
-					{
-						if (i < (nBus + 1) * 8)
-						{
-							sendfx_mixer[nFX]->doAddMix(i, m_OutputLevel[i]);
-						}
-					}
-
-					if (!m_nBusParameter[nBus][Bus::Parameter::FXBypass])
-					{
-						m_FXSpinLock.Acquire();
-						fx_chain[nFX]->process(FXSendBuffer[0], FXSendBuffer[1], nFrames);
-						m_FXSpinLock.Release();
-					}
 
 					arm_add_f32(BusBuffer[0], FXSendBuffer[0], BusBuffer[0], static_cast<uint32_t>(nFrames));
 					arm_add_f32(BusBuffer[1], FXSendBuffer[1], BusBuffer[1], static_cast<uint32_t>(nFrames));
@@ -2568,73 +3140,93 @@ void CMiniDexed::ProcessSound()
 					arm_scale_f32(BusBuffer[1], m_fBusGain[nBus], BusBuffer[1], static_cast<uint32_t>(nFrames));
 				}
 
-				if (nBus != 0)
+				if (nBus != 0 && !m_bQuadDACBuses)
 				{
 					arm_add_f32(MasterBuffer[0], BusBuffer[0], MasterBuffer[0], static_cast<uint32_t>(nFrames));
 					arm_add_f32(MasterBuffer[1], BusBuffer[1], MasterBuffer[1], static_cast<uint32_t>(nFrames));
 				}
 			}
 
-			m_FXSpinLock.Acquire();
-			fx_chain[CConfig::MasterFX]->process(MasterBuffer[0], MasterBuffer[1], nFrames);
-			m_FXSpinLock.Release();
-
-			// swap stereo channels if needed prior to writing back out
-			if (m_bChannelsSwapped)
+			if (m_bQuadDACBuses)
 			{
-				indexL = 1;
-				indexR = 0;
+				ApplyFXParameters(CConfig::MasterFX);
+				WriteBusOutputs(nFrames);
 			}
-
-			// Convert dual float array (left, right) to single int32 (q23) array (left/right)
-			if (m_bVolRampDownWait)
+			else
 			{
-				float targetVol = 0.0f;
+				// the master stage contains its FX slots
+				unsigned nStartTicks = m_Profiler.Start();
+
+				ApplyFXParameters(CConfig::MasterFX);
+				fx_chain[CConfig::MasterFX]->process(MasterBuffer[0], MasterBuffer[1], nFrames);
+
+				// swap stereo channels if needed prior to writing back out
+				if (m_bChannelsSwapped)
+				{
+					indexL = 1;
+					indexR = 0;
+				}
 
-				scale_ramp_f32(MasterBuffer[0], &m_fMasterVolume[0], targetVol, m_fRamp, MasterBuffer[0], nFrames);
-				scale_ramp_f32(MasterBuffer[1], &m_fMasterVolume[1], targetVol, m_fRamp, MasterBuffer[1], nFrames);
-				arm_zip_f32(MasterBuffer[indexL], MasterBuffer[indexR], tmp_float, nFrames);
+				m_Profiler.Stop(CAudioProfiler::MasterStage, nStartTicks);
 
-				if (targetVol == m_fMasterVolume[0] && targetVol == m_fMasterVolume[1])
+				// Scale or ramp the master volume, zip and convert to q23 (left/right) in one pass
+				nStartTicks = m_Profiler.Start();
+				if (m_bVolRampedDown)
+				{
+					m_fMasterVolume[0] = m_fMasterVolume[1] = 0.0f;
+				}
+
+				float targetVol = m_bVolRampDownWait || m_bVolRampedDown ? 0.0f : m_fMasterVolumeW;
+
+				arm_scale_ramp_zip_q23(MasterBuffer[indexL], MasterBuffer[indexR],
+					&m_fMasterVolume[indexL], &m_fMasterVolume[indexR],
+					targetVol, m_fRamp, m_pOutputBuffer, nFrames);
+				m_Profiler.Stop(CAudioProfiler::Q23Stage, nStartTicks);
+
+				if (m_bVolRampDownWait && m_fMasterVolume[0] == 0.0f && m_fMasterVolume[1] == 0.0f)
 				{
 					m_bVolRampDownWait = false;
 					m_bVolRampedDown = true;
 				}
-			}
-			else if (m_bVolRampedDown)
-			{
-				arm_scale_zip_f32(MasterBuffer[indexL], MasterBuffer[indexR], 0.0f, tmp_float, nFrames);
-			}
-			else if (m_fMasterVolume[0] == m_fMasterVolumeW && m_fMasterVolume[1] == m_fMasterVolumeW)
-			{
-				arm_scale_zip_f32(MasterBuffer[indexL], MasterBuffer[indexR], m_fMasterVolumeW, tmp_float, nFrames);
-			}
-			else
-			{
-				scale_ramp_f32(MasterBuffer[0], &m_fMasterVolume[0], m_fMasterVolumeW, m_fRamp, MasterBuffer[0], nFrames);
-				scale_ramp_f32(MasterBuffer[1], &m_fMasterVolume[1], m_fMasterVolumeW, m_fRamp, MasterBuffer[1], nFrames);
-				arm_zip_f32(MasterBuffer[indexL], MasterBuffer[indexR], tmp_float, nFrames);
-			}
-
-			arm_float_to_q23(tmp_float, tmp_int, nFrames * 2);
 
-			// Prevent PCM510x analog mute from kicking in
-			if (tmp_int[nFrames * 2 - 1] == 0)
-			{
-				tmp_int[nFrames * 2 - 1]++;
-			}
+				// Prevent PCM510x analog mute from kicking in
+				if (m_pOutputBuffer[nFrames * 2 - 1] == 0)
+				{
+					m_pOutputBuffer[nFrames * 2 - 1]++;
+				}
 
-			if (m_pSoundDevice->Write(tmp_int, sizeof(tmp_int)) != ssizeof(tmp_int))
-			{
-				LOGERR("Sound data dropped");
+				nStartTicks = m_Profiler.Start();
+				int nBytes = nFrames * 2 * ssizeof(int32_t);
+				if (m_pSoundDevice->Write(m_pOutputBuffer, nBytes) != nBytes)
+				{
+					LOGERR("Sound data dropped");
+				}
+				m_Profiler.Stop(CAudioProfiler::WriteStage, nStartTicks);
 			}
 		} // End of Stereo mixing
 
+		if (m_bPipelined)
+		{
+			std::swap(m_nRenderBuffer, m_nMixBuffer);
+		}
+
+		if (m_bLoadGovernor && m_LoadGovernor.Update(CTimer::GetClockTicks() - nBlockStartTicks))
+		{
+			ApplyLoadLevel(m_LoadGovernor.GetLevel());
+		}
+
+		m_nFXBlocks.fetch_add(1, std::memory_order_release);
+		m_Profiler.EndBlock();
+
 		if (m_bProfileEnabled)
 		{
 			m_GetChunkTimer.Stop();
 		}
+
+		return true;
 	}
+
+	return false;
 }
 
 #endif
@@ -3200,7 +3792,6 @@ void CMiniDexed::loadVoiceParameters(const uint8_t *data, int nTG)
 	}
 
 	m_pTG[nTG]->loadVoiceParameters(&voice[6]);
-	m_pTG[nTG]->doRefreshVoice();
 	setOPMask(0b111111, nTG);
 
 	m_UI.ParameterChanged();
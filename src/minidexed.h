@@ -34,17 +34,19 @@
 #include <circle/sched/scheduler.h>
 #include <circle/sound/soundbasedevice.h>
 #include <circle/spimaster.h>
-#include <circle/spinlock.h>
 #include <fatfs/ff.h>
 #include <wlan/bcm4343.h>
 #include <wlan/hostap/wpa_supplicant/wpasupplicant.h>
 
 #include "bus.h"
+#include "audioarena.h"
 #include "config.h"
 #include "dexedadapter.h"
 #include "effect.h"
 #include "effect_chain.h"
 #include "effect_mixer.hpp"
+#include "jobqueue.h"
+#include "loadgovernor.h"
 #include "midikeyboard.h"
 #include "net/ftpdaemon.h"
 #include "net/mdnspublisher.h"
@@ -314,10 +316,28 @@ public:
 
 private:
 	bool ApplyNoteLimits(int *pitch, int nTG); // returns < 0 to ignore note
+	zyn::Sympathetic *GetSympathetic(int nFX, int nTG);
 	uint8_t m_uchOPMask[CConfig::AllToneGenerators];
 	void LoadPerformanceParameters();
 	void LoadPerformanceParameters(CPerformanceConfig *config, int nBusFrom, int nBusCount, int nBusTarget, int LoadType, int nChannelTarget);
-	void ProcessSound();
+	bool ProcessSound(); // returns true, if a block has been written
+	unsigned GetBlockTicks(int nFrames);
+	void SetFXParameterPending(FX::Parameter Parameter, int nFX);
+	bool IsFXParameterPending(FX::Parameter Parameter, int nFX) const;
+	void SelectFXEffect(int nEffectID, int nFX);
+	void UnselectFXEffects(int nFX);
+	void UpdateFXEffects();
+	void ApplyFXParameters(int nFX);
+	void ApplyFXParameter(FX::Parameter Parameter, int nFX);
+#ifdef ARM_ALLOW_MULTI_CORE
+	static void SoundNeedDataHandler(void *pParam);
+	void DispatchJobs();
+	void ProcessJobs();
+	void RunJob(int nJob);
+	void MixBus(AudioStereoMixer<CConfig::AllToneGenerators> *pMixer, int nBus);
+	void ApplyLoadLevel(int nLevel);
+	void WriteBusOutputs(int nFrames);
+#endif
 	const char *GetNetworkDeviceShortName() const;
 
 #ifdef ARM_ALLOW_MULTI_CORE
@@ -423,28 +443,64 @@ private:
 
 	bool m_bUseSerial;
 	bool m_bQuadDAC8Chan;
+	bool m_bQuadDACBuses; // each bus to its own stereo pair
 
 	CSoundBaseDevice *m_pSoundDevice;
+	CAudioArena m_AudioArena;
+	int32_t *m_pOutputBuffer; // q23 samples of one block
+#ifndef ARM_ALLOW_MULTI_CORE
+	float *m_pSampleBuffer;
+#endif
 	bool m_bChannelsSwapped;
 	int m_nQueueSizeFrames;
 
+	unsigned m_nClockTicks; // the blocks are timed from here
+	uint64_t m_nClockFrames; // frames rendered since
+
 #ifdef ARM_ALLOW_MULTI_CORE
 	//	int m_nActiveTGsLog2;
 	std::atomic<TCoreStatus> m_CoreStatus[CORES];
 	std::atomic<int> m_nFramesToProcess;
-	float m_OutputLevel[CConfig::AllToneGenerators][CConfig::MaxChunkSize];
+	std::atomic<unsigned> m_nBlockTicks; // the TGs place their commands by it
+	int m_nRenderFrames; // frames per block
+	int m_nQueueFillFrames; // render until the queue holds this many frames
+	// job numbers: TGs, then bus mixes, then send FX chains
+	static constexpr int BusJobs = CConfig::AllToneGenerators;
+	static constexpr int FXJobs = BusJobs + CConfig::Buses;
+	static constexpr int AllJobs = FXJobs + CConfig::FXMixers;
+
+	CJobQueue<AllJobs> m_Jobs;
+	// in the current block
+	bool m_bTGRendered[2][CConfig::AllToneGenerators]; // per output buffer
+	bool m_bBusRendered[CConfig::Buses];
+	bool m_bFXRendered[CConfig::FXMixers];
+	// two buffers if the TGs are rendered a block ahead of the mix (pipelined)
+	float *m_OutputLevel[2][CConfig::AllToneGenerators]; // GetRenderQuantum() frames each, from m_AudioArena
+	bool m_bPipelined;
+	int m_nRenderBuffer; // TGs render into this buffer
+	int m_nMixBuffer; // bus and send FX jobs read from this buffer
+	bool m_bLoadGovernor;
+	CLoadGovernor m_LoadGovernor;
+	std::atomic<int> m_nLoadLevel; // set by core 1, logged by core 0
+	int m_nLoggedLoadLevel;
 #endif
 
 	int m_nLastKeyDown;
 
 	CPerformanceTimer m_GetChunkTimer;
 	bool m_bProfileEnabled;
+	CAudioProfiler m_Profiler;
 
+	AudioFXPool *m_pFXPool;
 	AudioFXChain *fx_chain[CConfig::FXChains];
 	AudioStereoMixer<CConfig::AllToneGenerators> *bus_mixer[CConfig::Buses];
 	AudioStereoMixer<CConfig::AllToneGenerators> *sendfx_mixer[CConfig::FXMixers];
 
-	CSpinLock m_FXSpinLock;
+	// FX parameters changed on core 0, bit-mapped, to be applied before the next block
+	static constexpr int FXParameterPendingWords = (FX::Parameter::Unknown + 31) / 32;
+	std::atomic<uint32_t> m_FXParameterPending[CConfig::FXChains][FXParameterPendingWords];
+	std::atomic<bool> m_bFXResetPending[CConfig::FXChains];
+	std::atomic<unsigned> m_nFXBlocks; // processed blocks, for releasing unused effects
 
 	CStatus m_Status;
 
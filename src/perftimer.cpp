@@ -19,10 +19,18 @@
 //
 #include "perftimer.h"
 
+#include <cassert>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
 #include <circle/cputhrottle.h>
+#include <circle/logger.h>
+#include <circle/multicore.h>
 #include <circle/timer.h>
+#include <fatfs/ff.h>
+
+LOGMODULE("profiler");
 
 CPerformanceTimer::CPerformanceTimer(const char *pName, unsigned nDeadlineMicros) :
 m_Name{pName},
@@ -81,3 +89,239 @@ void CPerformanceTimer::Dump(unsigned nIntervalTicks)
 		std::cout << std::endl;
 	}
 }
+
+CAudioProfiler::CAudioProfiler(bool bEnabled, unsigned nDeadlineMicros) :
+m_bEnabled{bEnabled},
+m_nDeadlineMicros{nDeadlineMicros},
+m_nBlocks{},
+m_nCount{},
+m_nMaximumMicros{},
+m_nCoreCount{},
+m_nHistogram{},
+m_nLastDumpTicks{}
+{
+	assert(m_nDeadlineMicros);
+
+	memset(m_Current.nMicros, 0xFF, sizeof m_Current.nMicros);
+
+	for (unsigned i = 0; i < RingSize; ++i)
+	{
+		m_Ring[i].nBlock = 0;
+		memset(m_Ring[i].nMicros, 0xFF, sizeof m_Ring[i].nMicros);
+	}
+}
+
+void CAudioProfiler::Stop(int nStage, unsigned nStartTicks)
+{
+	if (!m_bEnabled)
+	{
+		return;
+	}
+
+	assert(nStage < Stages);
+
+	unsigned nMicros = (CTimer::GetClockTicks() - nStartTicks) / (CLOCKHZ / 1000000);
+
+#ifdef ARM_ALLOW_MULTI_CORE
+	unsigned nCore = CMultiCoreSupport::ThisCore();
+#else
+	unsigned nCore = 0;
+#endif
+
+	m_Current.nMicros[nStage] = nMicros < NotRun ? nMicros : NotRun - 1;
+	m_Current.nCore[nStage] = nCore;
+}
+
+void CAudioProfiler::EndBlock()
+{
+	if (!m_bEnabled)
+	{
+		return;
+	}
+
+	for (int i = 0; i < Stages; ++i)
+	{
+		unsigned nMicros = m_Current.nMicros[i];
+		if (nMicros == NotRun)
+		{
+			continue;
+		}
+
+		unsigned nBucket = nMicros * BucketsPerDeadline / m_nDeadlineMicros;
+		m_nHistogram[i][nBucket < Buckets ? nBucket : Buckets - 1]++;
+		m_nCoreCount[i][m_Current.nCore[i]]++;
+		m_nCount[i]++;
+
+		if (nMicros > m_nMaximumMicros[i])
+		{
+			m_nMaximumMicros[i] = nMicros;
+		}
+	}
+
+	m_Current.nBlock = m_nBlocks++;
+	m_Ring[m_Current.nBlock % RingSize] = m_Current;
+
+	memset(m_Current.nMicros, 0xFF, sizeof m_Current.nMicros);
+}
+
+void CAudioProfiler::Dump(unsigned nIntervalTicks, const char *pFileName)
+{
+	unsigned nTicks = CTimer::GetClockTicks();
+
+	if (!m_bEnabled || nTicks - m_nLastDumpTicks < nIntervalTicks)
+	{
+		return;
+	}
+
+	m_nLastDumpTicks = nTicks;
+
+	LOGNOTE("%u blocks, deadline %uus", m_nBlocks, m_nDeadlineMicros);
+
+	for (int i = 0; i < Stages; ++i)
+	{
+		unsigned nCount = m_nCount[i]; // may be updated by core 1 meanwhile
+		if (!nCount)
+		{
+			continue;
+		}
+
+		unsigned nP50 = GetPercentileMicros(i, 500);
+		unsigned nP99 = GetPercentileMicros(i, 990);
+		unsigned nMax = m_nMaximumMicros[i];
+
+		// share of the blocks, in which each core has run the stage
+		char Cores[10 * CORES] = "";
+		for (unsigned nCore = 0; nCore < CORES; ++nCore)
+		{
+			if (m_nCoreCount[i][nCore])
+			{
+				size_t nLen = strlen(Cores);
+				snprintf(Cores + nLen, sizeof Cores - nLen, " %u:%u%%", nCore, m_nCoreCount[i][nCore] * 100 / nCount);
+			}
+		}
+
+		LOGNOTE("%s: p50 %uus (%u%%) p99 %uus (%u%%) max %uus (%u%%) core%s",
+			GetStageName(i).c_str(),
+			nP50, nP50 * 100 / m_nDeadlineMicros,
+			nP99, nP99 * 100 / m_nDeadlineMicros,
+			nMax, nMax * 100 / m_nDeadlineMicros,
+			Cores);
+	}
+
+	if (pFileName && !Save(pFileName))
+	{
+		LOGERR("Cannot save %s", pFileName);
+	}
+}
+
+std::string CAudioProfiler::GetStageName(int nStage) const
+{
+	char Name[20];
+
+	if (nStage < BusStage)
+	{
+		snprintf(Name, sizeof Name, "TG%d", nStage - TGStage + 1);
+	}
+	else if (nStage < FXStage)
+	{
+		snprintf(Name, sizeof Name, "Bus%d", nStage - BusStage + 1);
+	}
+	else if (nStage < MasterStage)
+	{
+		int nFX = (nStage - FXStage) / FX::slots_num;
+		int nSlot = (nStage - FXStage) % FX::slots_num;
+
+		if (nFX == CConfig::MasterFX)
+		{
+			snprintf(Name, sizeof Name, "MFX Slot%d", nSlot + 1);
+		}
+		else
+		{
+			snprintf(Name, sizeof Name, "B%d FX%d Slot%d", nFX / CConfig::BusFXChains + 1, nFX % CConfig::BusFXChains + 1, nSlot + 1);
+		}
+	}
+	else if (nStage == MasterStage)
+	{
+		return "Master";
+	}
+	else if (nStage == Q23Stage)
+	{
+		return "Q23";
+	}
+	else
+	{
+		return "Write";
+	}
+
+	return Name;
+}
+
+// upper bound of the bucket, which contains the percentile
+unsigned CAudioProfiler::GetPercentileMicros(int nStage, unsigned nPermille) const
+{
+	unsigned nLimit = (m_nCount[nStage] * nPermille + 999) / 1000;
+	unsigned nSum = 0;
+
+	for (unsigned i = 0; i < Buckets; ++i)
+	{
+		nSum += m_nHistogram[nStage][i];
+		if (nSum >= nLimit)
+		{
+			return (i + 1) * m_nDeadlineMicros / BucketsPerDeadline;
+		}
+	}
+
+	return m_nMaximumMicros[nStage];
+}
+
+// One line per block of the ring buffer, with the duration in us and the core
+// of each stage. The block, which is written by core 1 meanwhile, may be torn.
+bool CAudioProfiler::Save(const char *pFileName) const
+{
+	FIL File;
+	if (f_open(&File, pFileName, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
+	{
+		return false;
+	}
+
+	std::string Line = "Block";
+	for (int i = 0; i < Stages; ++i)
+	{
+		Line += "," + GetStageName(i) + "," + "Core";
+	}
+	Line += "\n";
+
+	bool bOK = true;
+	UINT nWritten;
+
+	bOK &= f_write(&File, Line.c_str(), Line.length(), &nWritten) == FR_OK && nWritten == Line.length();
+
+	unsigned nBlocks = m_nBlocks;
+	unsigned nFirst = nBlocks > RingSize ? nBlocks - RingSize : 0;
+
+	for (unsigned nBlock = nFirst; bOK && nBlock < nBlocks; ++nBlock)
+	{
+		const TBlock &Block = m_Ring[nBlock % RingSize];
+
+		char Buffer[16];
+		snprintf(Buffer, sizeof Buffer, "%u", Block.nBlock);
+		Line = Buffer;
+
+		for (int i = 0; i < Stages; ++i)
+		{
+			if (Block.nMicros[i] == NotRun)
+			{
+				Line += ",,";
+				continue;
+			}
+
+			snprintf(Buffer, sizeof Buffer, ",%u,%u", Block.nMicros[i], Block.nCore[i]);
+			Line += Buffer;
+		}
+		Line += "\n";
+
+		bOK &= f_write(&File, Line.c_str(), Line.length(), &nWritten) == FR_OK && nWritten == Line.length();
+	}
+
+	return f_close(&File) == FR_OK && bOK;
+}
@@ -19,10 +19,15 @@
 //
 #pragma once
 
+#include <cstdint>
 #include <string>
 
+#include <circle/sysconfig.h>
 #include <circle/timer.h>
 
+#include "config.h"
+#include "effect.h"
+
 class CPerformanceTimer
 {
 public:
@@ -43,3 +48,65 @@ private:
 
 	unsigned m_nLastDumpTicks;
 };
+
+// Profiler of the stages of the audio path, with histograms relative to the
+// block deadline. The stages are timed by all audio cores, the statistics and
+// the ring buffer of the last blocks are only updated by core 1 at the end of
+// a block, and read by core 0.
+class CAudioProfiler
+{
+public:
+	static const int TGStage = 0;
+	static const int BusStage = TGStage + CConfig::AllToneGenerators;
+	static const int FXStage = BusStage + CConfig::Buses; // + nFX * FX::slots_num + nSlot
+	static const int MasterStage = FXStage + CConfig::FXChains * FX::slots_num;
+	static const int Q23Stage = MasterStage + 1;
+	static const int WriteStage = Q23Stage + 1;
+	static const int Stages = WriteStage + 1;
+
+	CAudioProfiler(bool bEnabled, unsigned nDeadlineMicros);
+
+	bool IsEnabled() const { return m_bEnabled; }
+
+	// any audio core
+	unsigned Start() const { return m_bEnabled ? CTimer::GetClockTicks() : 0; }
+	void Stop(int nStage, unsigned nStartTicks);
+
+	// core 1, after all stages of the block
+	void EndBlock();
+
+	// core 0, to the log (and syslog) and to a file, which can be fetched by FTP
+	void Dump(unsigned nIntervalTicks = 10 * CLOCKHZ, const char *pFileName = "profile.csv");
+
+private:
+	std::string GetStageName(int nStage) const;
+	unsigned GetPercentileMicros(int nStage, unsigned nPermille) const;
+	bool Save(const char *pFileName) const;
+
+	static const unsigned BucketsPerDeadline = 200;
+	static const unsigned Buckets = 256;
+	static const unsigned RingSize = 128;
+	static const uint16_t NotRun = 0xFFFF;
+
+	struct TBlock
+	{
+		unsigned nBlock;
+		uint16_t nMicros[Stages];
+		uint8_t nCore[Stages];
+	};
+
+	bool m_bEnabled;
+	unsigned m_nDeadlineMicros;
+
+	TBlock m_Current;
+	unsigned m_nBlocks;
+
+	unsigned m_nCount[Stages];
+	unsigned m_nMaximumMicros[Stages];
+	unsigned m_nCoreCount[Stages][CORES];
+	unsigned m_nHistogram[Stages][Buckets];
+
+	TBlock m_Ring[RingSize];
+
+	unsigned m_nLastDumpTicks;
+};
@@ -0,0 +1,86 @@
+//
+// spscqueue.h
+//
+// MiniDexed - Dexed FM synthesizer for bare metal Raspberry Pi
+// Copyright (C) 2022  The MiniDexed Team
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <atomic>
+
+// Wait-free ring buffer for one producer and one consumer,
+// which may run on different cores. Size must be a power of two.
+
+template <typename T, unsigned Size>
+class CSPSCQueue
+{
+	static_assert((Size & (Size - 1)) == 0, "Size must be a power of two");
+
+public:
+	CSPSCQueue() :
+	m_nHead{},
+	m_nTail{}
+	{
+	}
+
+	// producer only, returns false if the queue is full
+	bool Put(const T &Item)
+	{
+		unsigned nHead = m_nHead.load(std::memory_order_relaxed);
+		if (nHead - m_nTail.load(std::memory_order_acquire) == Size)
+		{
+			return false;
+		}
+
+		m_Items[nHead & (Size - 1)] = Item;
+		m_nHead.store(nHead + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// consumer only, returns false if the queue is empty
+	bool Get(T *pItem)
+	{
+		unsigned nTail = m_nTail.load(std::memory_order_relaxed);
+		if (nTail == m_nHead.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		*pItem = m_Items[nTail & (Size - 1)];
+		m_nTail.store(nTail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// exact only when called by the consumer
+	unsigned GetCount() const
+	{
+		return m_nHead.load(std::memory_order_acquire) - m_nTail.load(std::memory_order_acquire);
+	}
+
+	bool IsEmpty() const
+	{
+		return GetCount() == 0;
+	}
+
+private:
+	T m_Items[Size];
+
+	// on separate cache lines, as they are written by different cores
+	alignas(64) std::atomic<unsigned> m_nHead;
+	alignas(64) std::atomic<unsigned> m_nTail;
+};
@@ -38,6 +38,7 @@ public:
 	void loadpreset(int npreset);
 	void changepar(int npar, int value);
 	int getpar(int npar) const;
+	float getwet() const { return wet; } // gain of the wet signal
 	void cleanup();
 
 	std::atomic<bool> bypass;
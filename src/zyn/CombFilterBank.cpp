@@ -9,53 +9,172 @@ namespace zyn
 
 CombFilterBank::CombFilterBank(float samplerate, float initgain) :
 delays{},
+active{},
+levels{},
 inputgain{1.0f},
 outgain{1.0f},
 gainbwd{initgain},
-string_smps{},
-basefreq{},
+lines{},
+offered{},
+returned{},
+groups_nr{},
+group_size{},
+group_writer{},
+processed{},
+prepared_groups_nr{-1},
+prepared_size{},
+temp{},
+gainbuf{},
 strings_nr{},
-pos_writer{},
-mem_size{},
 samplerate{samplerate}
 {
 	gain_smoothing.cutoff(1.0f);
 	gain_smoothing.sample_rate(samplerate / 16);
 	gain_smoothing.thresh(0.02f);
 	gain_smoothing.reset(gainbwd);
+
+	std::fill_n(active, max_strings, true);
+}
+
+CombFilterBank::~CombFilterBank()
+{
+	for (Lines *l : {lines, offered.load(), returned.load()})
+	{
+		if (l) delete[] l->smps;
+		delete l;
+	}
 }
 
-void CombFilterBank::setStrings(int strings_nr_n, float basefreq_n)
+// Each group of lanes gets the length its longest string needs.
+int CombFilterBank::getLayout(const float *delays_n, int nr, int *group_size_n)
 {
-	strings_nr_n = std::min(max_strings, strings_nr_n);
+	int groups_nr_n = (nr + lanes - 1) / lanes;
+
+	for (int g = 0; g < groups_nr_n; ++g)
+	{
+		float longest = 0.0f;
+		for (int j = g * lanes; j < std::min(nr, (g + 1) * lanes); ++j)
+			longest = std::max(longest, delays_n[j]);
+
+		group_size_n[g] = std::min(max_samples, static_cast<int>(ceilf((longest * 1.03f /*+ buffersize*/ + 2) / 16) * 16));
+	}
 
-	if (strings_nr_n == strings_nr && basefreq_n == basefreq)
+	return groups_nr_n;
+}
+
+void CombFilterBank::setStrings(int strings_nr_n)
+{
+	strings_nr = std::min(max_strings, strings_nr_n);
+	groups_nr = getLayout(delays, strings_nr, group_size);
+}
+
+void CombFilterBank::prepare(const float *delays_n, int nr)
+{
+	reclaim();
+
+	nr = std::min(max_strings, nr);
+
+	int group_size_n[max_groups];
+	int groups_nr_n = getLayout(delays_n, nr, group_size_n);
+	if (groups_nr_n == prepared_groups_nr && std::equal(group_size_n, group_size_n + groups_nr_n, prepared_size))
 		return;
 
-	int mem_size_n = std::min(max_samples, static_cast<int>(ceilf((samplerate / basefreq_n * 1.03f /*+ buffersize*/ + 2) / 16) * 16));
-	if (mem_size_n == mem_size)
+	Lines *l = new Lines;
+	assert(l);
+	l->groups_nr = groups_nr_n;
+	l->smps_size = 0;
+	for (int g = 0; g < groups_nr_n; ++g)
 	{
-		if (strings_nr_n > strings_nr)
-		{
-			for (int i = strings_nr; i < strings_nr_n; ++i)
-			{
-				std::fill_n(string_smps[i], mem_size_n, 0.0f);
-			}
-		}
+		l->group_size[g] = group_size_n[g];
+		l->group_start[g] = l->smps_size;
+		l->smps_size += (group_size_n[g] + 1) * lanes;
+	}
+	l->smps = new float[l->smps_size]{};
+	assert(l->smps);
+
+	prepared_groups_nr = groups_nr_n;
+	std::copy_n(group_size_n, groups_nr_n, prepared_size);
+
+	// lines offered before, but not taken yet, are not needed anymore
+	Lines *old = offered.exchange(l, std::memory_order_acq_rel);
+	if (old)
+	{
+		delete[] old->smps;
+		delete old;
 	}
-	else
+}
+
+void CombFilterBank::reclaim()
+{
+	Lines *l = returned.exchange(nullptr, std::memory_order_acquire);
+	if (l)
 	{
-		for (int i = 0; i < strings_nr_n; ++i)
+		delete[] l->smps;
+		delete l;
+	}
+}
+
+bool CombFilterBank::fits(const Lines *l) const
+{
+	return l && l->groups_nr == groups_nr && std::equal(group_size, group_size + groups_nr, l->group_size);
+}
+
+// Takes the offered lines, if they fit the strings. The strings, which are
+// processed, go on ringing with their latest samples, the writers of the new
+// lines start at 0. The other lines are silent, as the new ones.
+void CombFilterBank::adopt()
+{
+	// core 0 has not deleted the lines returned last yet
+	if (returned.load(std::memory_order_acquire))
+		return;
+
+	Lines *l = offered.exchange(nullptr, std::memory_order_acq_rel);
+	if (!l)
+		return;
+
+	if (!fits(l))
+	{
+		// kept for a later change of the strings, unless newer lines are offered
+		Lines *expected = nullptr;
+		if (!offered.compare_exchange_strong(expected, l, std::memory_order_acq_rel))
+			returned.store(l, std::memory_order_release);
+		return;
+	}
+
+	int kept_nr = lines ? std::min(strings_nr, lines->groups_nr * lanes) : 0;
+	for (int j = 0; j < kept_nr; ++j)
+	{
+		if (!processed[j])
+			continue;
+
+		int g = j / lanes;
+		int k = j % lanes;
+		frame_t *line = getLine(g);
+		frame_t *line_n = reinterpret_cast<frame_t *>(l->smps + l->group_start[g]);
+		int size = lines->group_size[g];
+		int size_n = l->group_size[g];
+		int count = std::min(size, size_n);
+
+		int t = group_writer[g] - count;
+		if (t < 0) t += size;
+		for (int i = size_n - count; i < size_n; ++i)
 		{
-			std::fill_n(string_smps[i], mem_size_n, 0.0f);
+			line_n[i][k] = line[t][k];
+			if (++t == size) t = 0;
 		}
-
-		mem_size = mem_size_n;
-		basefreq = basefreq_n;
-		pos_writer = 0;
 	}
+	std::fill(processed + kept_nr, processed + max_strings, false);
 
-	strings_nr = strings_nr_n;
+	returned.store(lines, std::memory_order_release);
+	lines = l;
+
+	for (int g = 0; g < groups_nr; ++g)
+	{
+		group_writer[g] = 0;
+
+		frame_t *line = getLine(g);
+		std::copy_n(line[0], lanes, line[group_size[g]]);
+	}
 }
 
 static float tanhX(float x)
@@ -66,70 +185,141 @@ static float tanhX(float x)
 	return x * (105.0f + 10.0f * x2) / (105.0f + (45.0f + x2) * x2);
 }
 
-static float sampleLerp(float *smp, float pos, int mem_size)
+void CombFilterBank::filterout(float *smp, int period)
 {
-	int poshi = pos;
-	float poslo = pos - poshi;
-	return smp[poshi] + poslo * (smp[(poshi + 1) % mem_size] - smp[poshi]);
+	if (!fits(lines))
+		adopt();
+
+	if (strings_nr == 0 || !lines || lines->groups_nr == 0) return;
+
+	// longer blocks are processed in parts, which fit into the buffers
+	for (int done = 0; done < period; done += max_period)
+		filterpart(smp + done, std::min(period - done, max_period));
 }
 
-void CombFilterBank::filterout(float *smp, int period)
+void CombFilterBank::filterpart(float *smp, int period)
 {
-	if (strings_nr == 0) return;
+	assert(period <= max_period);
 
 	// interpolate gainbuf values over buffer length using value smoothing filter (lp)
 	// this should prevent popping noise when controlled binary with 0 / 127
 	// new control rate = samplerate / 16
 	int gainbufsize = period / 16;
-	float gainbuf[gainbufsize];
 
 	if (!gain_smoothing.apply(gainbuf, gainbufsize, gainbwd))
 		std::fill_n(gainbuf, gainbufsize, gainbwd); // if nothing to interpolate (constant value)
 
-	float temp[period];
 	std::fill_n(temp, period, 0);
 
 	int strings_act_nr = 0;
 
-	for (int j = 0; j < strings_nr; ++j)
+	// until the lines for a change are taken, the strings use the former ones
+	int lines_nr = std::min(strings_nr, lines->groups_nr * lanes);
+
+	for (int g = 0; g * lanes < lines_nr; ++g)
 	{
-		if (delays[j] == 0.0f) continue;
+		frame_t *string = getLine(g);
+		int mem_size = lines->group_size[g];
+		int pos_writer_ = group_writer[g];
+		group_writer[g] = (pos_writer_ + period) % mem_size;
 
-		strings_act_nr++;
+		// the reading position of a lane is a fixed offset from the writer,
+		// the input passes through each string, whether it is processed or not
+		// a deactivated string fades out in this block, its line is cleared after it
+		bool lane_active[lanes];
+		bool lane_retired[lanes];
+		float fade[lanes];
+		float fade_step[lanes];
+		int offset[lanes];
+		float frac[lanes];
+		float peak[lanes] = {};
+		bool group_active = false;
 
-		int pos_writer_ = pos_writer;
-		float delay = delays[j];
+		for (int k = 0; k < lanes; ++k)
+		{
+			int j = g * lanes + k;
+			bool used = j < lines_nr && delays[j] != 0.0f;
+			lane_retired[k] = used && !active[j] && processed[j];
+			lane_active[k] = (used && active[j]) || lane_retired[k];
+			group_active |= lane_active[k];
+			strings_act_nr += used;
+
+			fade[k] = 1.0f;
+			fade_step[k] = lane_retired[k] ? -1.0f / period : 0.0f;
 
-		for (int i = 0; i < period; ++i)
+			float pos = lane_active[k] ? std::max(0.0f, mem_size - delays[j]) : 0.0f;
+			offset[k] = static_cast<int>(pos);
+			frac[k] = pos - offset[k];
+			if (offset[k] >= mem_size) offset[k] -= mem_size;
+		}
+
+		for (int done = 0; group_active && done < period;)
 		{
-			float input_smp = smp[i] * inputgain;
-			float gain = gainbuf[i / 16];
+			// a span ends before the writer or a reader wraps around,
+			// the mirrored first sample is written on its own
+			int reader[lanes];
+			int n = pos_writer_ ? std::min(period - done, mem_size - pos_writer_) : 1;
+			for (int k = 0; k < lanes; ++k)
+			{
+				reader[k] = pos_writer_ + offset[k];
+				if (reader[k] >= mem_size) reader[k] -= mem_size;
+				n = std::min(n, mem_size - reader[k]);
+			}
+
+			for (int i = 0; i < n; ++i)
+			{
+				float input_smp = smp[done + i] * inputgain;
+				float gain = gainbuf[(done + i) / 16];
+				float *out = string[pos_writer_ + i];
+				float sum = 0.0f;
+
+				for (int k = 0; k < lanes; ++k)
+				{
+					float a = string[reader[k] + i][k];
+					float b = string[reader[k] + i + 1][k];
+					float feedback = tanhX((a + frac[k] * (b - a)) * gain) * fade[k];
+					fade[k] = std::max(0.0f, fade[k] + fade_step[k]);
 
-			float pos_reader = pos_writer_ + mem_size - delay;
-			if (pos_reader > mem_size) pos_reader -= mem_size;
+					out[k] = lane_active[k] ? input_smp + feedback : out[k];
+					sum += lane_active[k] ? feedback : 0.0f;
+					peak[k] = std::max(peak[k], lane_active[k] ? fabsf(feedback) : 0.0f);
+				}
 
-			float sample = sampleLerp(string_smps[j], pos_reader, mem_size);
-			temp[i] += string_smps[j][pos_writer_] = input_smp + tanhX(sample * gain);
+				temp[done + i] += sum;
+			}
+
+			if (pos_writer_ == 0)
+				std::copy_n(string[0], lanes, string[mem_size]);
 
-			pos_writer_ = (pos_writer_ + 1) % mem_size;
+			pos_writer_ = (pos_writer_ + n) % mem_size;
+			done += n;
 		}
-	}
 
-	pos_writer = (pos_writer + period) % mem_size;
+		for (int k = 0; k < lanes && g * lanes + k < lines_nr; ++k)
+		{
+			int j = g * lanes + k;
+			levels[j] = lane_retired[k] ? 0.0f : peak[k];
+			processed[j] = lane_active[k] && !lane_retired[k];
+
+			// a string activated again starts from silence
+			if (lane_retired[k])
+				for (int t = 0; t <= mem_size; ++t)
+					string[t][k] = 0.0f;
+		}
+	}
 
 	float gain = outgain / strings_act_nr;
+	float input_gain = inputgain * strings_act_nr;
 	for (int i = 0; i < period; ++i)
 	{
-		smp[i] = temp[i] * gain;
+		smp[i] = (temp[i] + smp[i] * input_gain) * gain;
 	}
 }
 
 void CombFilterBank::cleanup()
 {
-	for (int i = 0; i < strings_nr; ++i)
-	{
-		std::fill_n(string_smps[i], mem_size, 0.0f);
-	}
+	if (lines)
+		std::fill_n(lines->smps, lines->smps_size, 0.0f);
 }
 
 } // namespace zyn
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "ValueSmoothingFilter.h"
 
 namespace zyn
@@ -10,6 +12,8 @@ class CombFilterBank
 {
 public:
 	CombFilterBank(float samplerate, float initgain);
+	~CombFilterBank();
+
 	void filterout(float *smp, int period);
 
 	void cleanup();
@@ -18,22 +22,70 @@ public:
 	static constexpr int max_samples = 6048;
 
 	float delays[max_strings];
+	bool active[max_strings]; // inactive strings fade out within a block, then are not processed
+	float levels[max_strings]; // peak of the feedback in the last block, 0 if not processed
 	float inputgain;
 	float outgain;
 	float gainbwd;
 
-	void setStrings(int nr, float basefreq);
+	// the delays of the strings must be set before, the lines for them
+	// are taken from prepare() at the next block
+	void setStrings(int nr);
+
+	// Allocates the lines for the delays of the strings, which setStrings()
+	// will get, and deletes the replaced ones. Called by core 0 only.
+	void prepare(const float *delays_n, int nr);
+	void reclaim();
 
 private:
-	float string_smps[max_strings][max_samples];
-	float basefreq;
+	void filterpart(float *smp, int period);
+
+	static constexpr int max_period = 256;
+
+	// The strings are processed in groups of lanes, whose samples are interleaved
+	// (structure of arrays). The sample after the end mirrors the first one,
+	// so the interpolation never wraps. The delay lines of a group are as long
+	// as its longest string needs, all groups share one allocation.
+	static constexpr int lanes = 4;
+	static constexpr int max_groups = max_strings / lanes;
+	static_assert(max_strings % lanes == 0, "strings must fill the lane groups");
+
+	typedef float frame_t[lanes];
+
+	// delay lines, allocated by core 0
+	struct Lines
+	{
+		int groups_nr;
+		int group_size[max_groups];
+		int group_start[max_groups];
+		int smps_size;
+		float *smps;
+	};
+
+	static int getLayout(const float *delays_n, int nr, int *group_size_n);
+	bool fits(const Lines *l) const;
+	void adopt();
+
+	frame_t *getLine(int group) { return reinterpret_cast<frame_t *>(lines->smps + lines->group_start[group]); }
+
+	Lines *lines;
+	std::atomic<Lines *> offered; // by core 0, taken at a block boundary
+	std::atomic<Lines *> returned; // replaced lines, deleted by core 0
+	int groups_nr; // the layout the strings need
+	int group_size[max_groups];
+	int group_writer[max_groups];
+	bool processed[max_strings];
+
+	int prepared_groups_nr; // the layout of the lines offered last, core 0 only
+	int prepared_size[max_groups];
+
+	float temp[max_period];
+	float gainbuf[max_period / 16];
 	int strings_nr;
-	int pos_writer;
 
 	/* for smoothing gain jump when using binary valued sustain pedal */
 	ValueSmoothingFilter gain_smoothing;
 
-	int mem_size;
 	float samplerate;
 };
 
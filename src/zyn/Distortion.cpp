@@ -13,6 +13,7 @@
 
 #include "Distortion.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
@@ -41,11 +42,14 @@ namespace zyn
 Distortion::Distortion(float samplerate) :
 samplerate{samplerate},
 Ppreset{},
+prepared{},
 lpfl{2, 20000, 1, 0, samplerate},
 lpfr{2, 20000, 1, 0, samplerate},
 hpfl{3, 20, 1, 0, samplerate},
-hpfr{3, 20, 1, 0, samplerate}
+hpfr{3, 20, 1, 0, samplerate},
+shaper{}
 {
+	preparepreset(Ppreset);
 	loadpreset(Ppreset);
 }
 
@@ -96,9 +100,9 @@ void Distortion::process(float *inputL, float *inputR, int period)
 	if (Pfiltering == FilteringPre)
 		applyfilters(tempL, tempR, period);
 
-	waveShapeSmps(period, tempL, Ptype, Pdrive, Poffset, Pshape);
+	shaper.process(period, tempL, Ptype, Pdrive, Poffset, Pshape);
 	if (Pstereo)
-		waveShapeSmps(period, tempR, Ptype, Pdrive, Poffset, Pshape);
+		shaper.process(period, tempR, Ptype, Pdrive, Poffset, Pshape);
 
 	if (Pfiltering == FilteringPost)
 		applyfilters(tempL, tempR, period);
@@ -231,9 +235,9 @@ int Distortion::ToIDFromPreset(const char *preset)
 	return 0;
 }
 
-void Distortion::loadpreset(int npreset)
+const signed char *Distortion::getpreset(int npreset)
 {
-	const signed char presets[presets_num][ParameterCount] = {
+	static constexpr signed char presets[presets_num][ParameterCount] = {
 		{
 			// Init
 			[ParameterMix] = 0,
@@ -351,12 +355,50 @@ void Distortion::loadpreset(int npreset)
 	if (npreset >= presets_num)
 		npreset = presets_num - 1;
 
+	return presets[npreset];
+}
+
+void Distortion::loadpreset(int npreset)
+{
+	const signed char *preset = getpreset(npreset);
+
 	for (int n = 0; n < ParameterCount; n++)
-		changepar(n, presets[npreset][n]);
+		changepar(n, preset[n]);
 
 	cleanup();
 }
 
+void Distortion::prepare(int npar, int value)
+{
+	prepared[npar] = static_cast<signed char>(value);
+
+	if (npar == ParameterDrive || npar == ParameterType || npar == ParameterShape || npar == ParameterOffset)
+		prepareshaper();
+}
+
+void Distortion::prepare(const int *params)
+{
+	for (int n = 0; n < ParameterCount; ++n)
+		prepared[n] = static_cast<signed char>(params[n]);
+	prepareshaper();
+}
+
+void Distortion::preparepreset(int npreset)
+{
+	std::copy_n(getpreset(npreset), ParameterCount, prepared);
+	prepareshaper();
+}
+
+void Distortion::prepareshaper()
+{
+	signed char type = prepared[ParameterType] > 16 ? 16 : prepared[ParameterType];
+
+	// the input volume of process(), a mono sum of both channels may exceed it
+	float inputvol = powf(5.0f, (prepared[ParameterDrive] - 32.0f) / 127.0f);
+
+	shaper.prepare(1.5f * inputvol, type, prepared[ParameterDrive], prepared[ParameterOffset], prepared[ParameterShape]);
+}
+
 void Distortion::changepar(int npar, int value)
 {
 	signed char cValue = static_cast<signed char>(value);
@@ -17,6 +17,7 @@
 #include <string>
 
 #include "AnalogFilter.h"
+#include "WaveShapeSmps.h"
 
 namespace zyn
 {
@@ -29,8 +30,15 @@ public:
 	void loadpreset(int npreset);
 	void changepar(int npar, int value);
 	int getpar(int npar) const;
+	float getwet() const { return 2.0f * level * wet; } // gain of the wet signal
 	void cleanup();
 
+	// The shaper table is built by core 0 with the parameters, before they
+	// are applied. Called by core 0 only.
+	void prepare(int npar, int value);
+	void prepare(const int *params); // all parameters, in Parameter order
+	void preparepreset(int npreset);
+
 	std::atomic<bool> bypass;
 
 	static constexpr int presets_num = 7;
@@ -67,6 +75,8 @@ public:
 
 private:
 	void applyfilters(float *inputL, float *inputR, int period);
+	static const signed char *getpreset(int npreset);
+	void prepareshaper();
 
 	float samplerate;
 
@@ -86,6 +96,7 @@ private:
 	signed char Plrcross; // L/R mix
 	signed char Pshape; // for waveshaper shape
 	signed char Poffset; // the input offset
+	signed char prepared[ParameterCount]; // the parameters for prepare(), core 0 only
 
 	void setmix(signed char _Pmix);
 	void setlowcut(signed char _Plowcut);
@@ -96,6 +107,7 @@ private:
 
 	// Real Parameters
 	AnalogFilter lpfl, lpfr, hpfl, hpfr;
+	WaveShaper shaper;
 
 	float dry, wet, panl, panr, level, lrcross;
 };
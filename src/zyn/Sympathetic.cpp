@@ -13,6 +13,7 @@
 
 #include "Sympathetic.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
@@ -40,15 +41,24 @@ static constexpr short MIDI_EQ_N = sizeof MIDI_EQ_HZ / sizeof *MIDI_EQ_HZ;
 static constexpr float gainbwd_offset = 0.873f;
 static constexpr float gainbwd_factor = 0.001f;
 
+// strings below this level are retired in silence, -100 dBFS
+static constexpr float retire_silence = 1e-5f;
+
 namespace zyn
 {
 
 Sympathetic::Sympathetic(float samplerate) :
 samplerate{samplerate},
+strings_nr{},
+string_notes{},
+notes_on{},
+sustained{},
+prepared{},
 lpf{2, 20000, 1, 0, samplerate},
 hpf{3, 20, 1, 0, samplerate},
 filterBank{samplerate, gainbwd_offset}
 {
+	preparepreset(0);
 	loadpreset(0);
 }
 
@@ -74,6 +84,7 @@ void Sympathetic::process(float *inputL, float *inputR, int period)
 	for (int i = 0; i < period; ++i)
 		temp[i] = (inputL[i] * panl + inputR[i] * panr) * inputvol;
 
+	activateStrings();
 	filterBank.filterout(temp, period);
 
 	if (Plowcut != 0) hpf.filterout(temp, period);
@@ -146,53 +157,71 @@ void Sympathetic::sethighcut(signed char _Phighcut)
 
 void Sympathetic::calcFreqs()
 {
-	switch (Ptype)
+	signed char par[ParameterCount];
+	for (int n = 0; n < ParameterCount; ++n)
+		par[n] = getpar(n);
+
+	strings_nr = calcDelays(par, samplerate, filterBank.delays, string_notes);
+	filterBank.setStrings(strings_nr * Punison_size);
+}
+
+// Calculates the delays and notes of the strings for the parameters,
+// returns the number of strings.
+int Sympathetic::calcDelays(const signed char *par, float samplerate, float *delays, int *notes)
+{
+	switch (par[ParameterType])
 	{
 	case TypeGeneric:
-		calcFreqsGeneric();
-		break;
+		return calcFreqsGeneric(par, samplerate, delays, notes);
 	case TypePiano:
-		calcFreqsPiano();
-		break;
+		return calcFreqsPiano(par, samplerate, delays, notes);
 	case TypeGuitar:
-		calcFreqsGuitar();
-		break;
+		return calcFreqsGuitar(par, samplerate, delays, notes);
 	default:
 		assert(false);
+		return 0;
 	}
 }
 
-void Sympathetic::calcFreqsGeneric()
+int Sympathetic::calcFreqsGeneric(const signed char *par, float samplerate, float *delays, int *notes)
 {
-	float unison_spread_semicent = powf(Punison_spread / 63.5f, 2.0f) * 25.0f;
+	int Punison_size = par[ParameterUnisonSize];
+	int Pbasenote = par[ParameterBaseNote];
+	float baseFreq = powf(2.0f, (Pbasenote - 69.0f) / 12.0f) * 440.0f;
+	float unison_spread_semicent = powf(par[ParameterUnisonSpread] / 63.5f, 2.0f) * 25.0f;
 	float unison_real_spread_up = powf(2.0f, (unison_spread_semicent * 0.5f) / 1200.0f);
 	float unison_real_spread_down = 1.0f / unison_real_spread_up;
 
-	for (int i = 0; i < Pstrings; ++i)
+	for (int i = 0; i < par[ParameterStrings]; ++i)
 	{
-		float centerFreq = powf(2.0f, i * Pinterval / 12.0f) * baseFreq;
+		float centerFreq = powf(2.0f, i * par[ParameterInterval] / 12.0f) * baseFreq;
+		notes[i] = Pbasenote + i * par[ParameterInterval];
 
 		int n = i * Punison_size;
-		filterBank.delays[n] = samplerate / centerFreq;
+		delays[n] = samplerate / centerFreq;
 
 		if (Punison_size > 1)
-			filterBank.delays[n + 1] = samplerate / (centerFreq * unison_real_spread_up);
+			delays[n + 1] = samplerate / (centerFreq * unison_real_spread_up);
 
 		if (Punison_size > 2)
-			filterBank.delays[n + 2] = samplerate / (centerFreq * unison_real_spread_down);
+			delays[n + 2] = samplerate / (centerFreq * unison_real_spread_down);
 	}
-	filterBank.setStrings(Pstrings * Punison_size, baseFreq);
+	return par[ParameterStrings];
 }
 
-void Sympathetic::calcFreqsPiano()
+int Sympathetic::calcFreqsPiano(const signed char *par, float samplerate, float *delays, int *notes)
 {
-	float unison_spread_semicent = powf(Punison_spread / 63.5f, 2.0f) * 25.0f;
+	int Punison_size = par[ParameterUnisonSize];
+	int Pbasenote = par[ParameterBaseNote];
+	float baseFreq = powf(2.0f, (Pbasenote - 69.0f) / 12.0f) * 440.0f;
+	float unison_spread_semicent = powf(par[ParameterUnisonSpread] / 63.5f, 2.0f) * 25.0f;
 	float unison_real_spread_up = powf(2.0f, (unison_spread_semicent * 0.5f) / 1200.0f);
 	float unison_real_spread_down = 1.0f / unison_real_spread_up;
 
-	for (int i = 0; i < Pstrings; ++i)
+	for (int i = 0; i < par[ParameterStrings]; ++i)
 	{
-		float centerFreq = powf(2.0f, i * Pinterval / 12.0f) * baseFreq;
+		float centerFreq = powf(2.0f, i * par[ParameterInterval] / 12.0f) * baseFreq;
+		notes[i] = Pbasenote + i * par[ParameterInterval];
 		int stringchoir_size;
 
 		if (centerFreq < 52.0f) // 1 string for Low bass section keys 1 - 12 (51.91 Hz)
@@ -203,52 +232,56 @@ void Sympathetic::calcFreqsPiano()
 			stringchoir_size = 3;
 
 		int n = i * Punison_size;
-		filterBank.delays[n] = samplerate / centerFreq;
+		delays[n] = samplerate / centerFreq;
 
 		if (Punison_size > 1)
 		{
 			if (stringchoir_size > 1)
-				filterBank.delays[n + 1] = samplerate / (centerFreq * unison_real_spread_up);
+				delays[n + 1] = samplerate / (centerFreq * unison_real_spread_up);
 			else
-				filterBank.delays[n + 1] = 0;
+				delays[n + 1] = 0;
 		}
 
 		if (Punison_size > 2)
 		{
 			if (stringchoir_size > 2)
-				filterBank.delays[n + 2] = samplerate / (centerFreq * unison_real_spread_down);
+				delays[n + 2] = samplerate / (centerFreq * unison_real_spread_down);
 			else
-				filterBank.delays[n + 2] = 0;
+				delays[n + 2] = 0;
 		}
 	}
-	filterBank.setStrings(Pstrings * Punison_size, baseFreq);
+	return par[ParameterStrings];
 }
 
-void Sympathetic::calcFreqsGuitar()
+int Sympathetic::calcFreqsGuitar(const signed char *par, float samplerate, float *delays, int *notes)
 {
+	int Punison_size = par[ParameterUnisonSize];
+	int Pbasenote = par[ParameterBaseNote];
+	float baseFreq = powf(2.0f, (Pbasenote - 69.0f) / 12.0f) * 440.0f;
 	// frequencies steps of a guitar in standard e tuning
 	// static constexpr float guitar_freqs[6] = {82.4f, 110.0f, 146.8f, 196.0f, 246.9f, 329.6f};
 	static constexpr int strings = 6;
 	static constexpr int steps[strings] = {0, 5, 10, 15, 19, 24};
 
-	float unison_spread_semicent = powf(Punison_spread / 63.5f, 2.0f) * 25.0f;
+	float unison_spread_semicent = powf(par[ParameterUnisonSpread] / 63.5f, 2.0f) * 25.0f;
 	float unison_real_spread_up = powf(2.0f, (unison_spread_semicent * 0.5f) / 1200.0f);
 	float unison_real_spread_down = 1.0f / unison_real_spread_up;
 
 	for (int i = 0; i < strings; ++i)
 	{
 		float centerFreq = powf(2.0f, steps[i] / 12.0f) * baseFreq;
+		notes[i] = Pbasenote + steps[i];
 
 		int n = i * Punison_size;
-		filterBank.delays[n] = samplerate / centerFreq;
+		delays[n] = samplerate / centerFreq;
 
 		if (Punison_size > 1)
-			filterBank.delays[n + 1] = samplerate / (centerFreq * unison_real_spread_up);
+			delays[n + 1] = samplerate / (centerFreq * unison_real_spread_up);
 
 		if (Punison_size > 2)
-			filterBank.delays[n + 2] = samplerate / (centerFreq * unison_real_spread_down);
+			delays[n + 2] = samplerate / (centerFreq * unison_real_spread_down);
 	}
-	filterBank.setStrings(strings * Punison_size, baseFreq);
+	return strings;
 }
 
 static const char *SympTypes[Sympathetic::types_num] = {
@@ -294,9 +327,9 @@ int Sympathetic::ToIDFromPreset(const char *preset)
 	return 0;
 }
 
-void Sympathetic::loadpreset(int npreset)
+const signed char *Sympathetic::getpreset(int npreset)
 {
-	const signed char presets[presets_num][ParameterCount] = {
+	static constexpr signed char presets[presets_num][ParameterCount] = {
 		{
 			// Init
 			[ParameterMix] = 0,
@@ -446,14 +479,42 @@ void Sympathetic::loadpreset(int npreset)
 	if (npreset >= presets_num)
 		npreset = presets_num - 1;
 
+	return presets[npreset];
+}
+
+void Sympathetic::loadpreset(int npreset)
+{
+	const signed char *preset = getpreset(npreset);
+
 	for (int n = 0; n < ParameterCount; n++)
-		changepar(n, presets[npreset][n], false);
+		changepar(n, preset[n], false);
 
 	calcFreqs();
 
 	cleanup();
 }
 
+// Limits the value of a parameter, which sets the strings.
+signed char Sympathetic::limitpar(int npar, int value, int type)
+{
+	signed char cValue = static_cast<signed char>(value);
+
+	switch (npar)
+	{
+	case ParameterType:
+		return cValue < types_num ? cValue : types_num - 1;
+	case ParameterUnisonSize:
+		return cValue < 1 ? 1 : cValue > 3 ? 3 : cValue;
+	case ParameterStrings:
+		if (type == TypeGuitar) return 6;
+		return cValue < 0 ? 0 : cValue > max_strings ? max_strings : cValue;
+	case ParameterInterval:
+		return cValue < 1 ? 1 : cValue > 10 ? 10 : cValue;
+	default:
+		return cValue;
+	}
+}
+
 void Sympathetic::changepar(int npar, int value, bool updateFreqs)
 {
 	bool needUpdate = false;
@@ -484,7 +545,7 @@ void Sympathetic::changepar(int npar, int value, bool updateFreqs)
 		filterBank.outgain = Plevel / 65.0f;
 		break;
 	case ParameterType:
-		cValue = cValue < types_num ? cValue : types_num - 1;
+		cValue = limitpar(npar, cValue, Ptype);
 		if (Ptype != cValue)
 		{
 			Ptype = cValue;
@@ -493,7 +554,7 @@ void Sympathetic::changepar(int npar, int value, bool updateFreqs)
 		break;
 	case ParameterUnisonSize:
 	{
-		cValue = cValue < 1 ? 1 : cValue > 3 ? 3 : cValue;
+		cValue = limitpar(npar, cValue, Ptype);
 		if (Punison_size != cValue)
 		{
 			Punison_size = cValue;
@@ -510,8 +571,7 @@ void Sympathetic::changepar(int npar, int value, bool updateFreqs)
 		break;
 	case ParameterStrings:
 	{
-		cValue = cValue < 0 ? 0 : cValue > 76 ? 76 : cValue;
-		if (Ptype == TypeGuitar) cValue = 6;
+		cValue = limitpar(npar, cValue, Ptype);
 		if (Pstrings != cValue)
 		{
 			Pstrings = cValue;
@@ -521,7 +581,7 @@ void Sympathetic::changepar(int npar, int value, bool updateFreqs)
 	break;
 	case ParameterInterval:
 	{
-		cValue = cValue < 1 ? 1 : cValue > 10 ? 10 : cValue;
+		cValue = limitpar(npar, cValue, Ptype);
 		if (Pinterval != cValue)
 		{
 			Pinterval = cValue;
@@ -533,7 +593,6 @@ void Sympathetic::changepar(int npar, int value, bool updateFreqs)
 		if (Pbasenote != cValue)
 		{
 			Pbasenote = cValue;
-			baseFreq = powf(2.0f, (Pbasenote - 69.0f) / 12.0f) * 440.0f;
 			needUpdate = true;
 		}
 		break;
@@ -596,6 +655,82 @@ int Sympathetic::getpar(int npar) const
 void Sympathetic::sustain(bool sustain)
 {
 	filterBank.gainbwd = gainbwd_offset + (sustain ? Pq_sustain : Pq) * gainbwd_factor;
+	sustained = sustain;
+}
+
+void Sympathetic::prepare(int npar, int value)
+{
+	prepared[npar] = limitpar(npar, value, prepared[ParameterType]);
+	preparestrings();
+}
+
+void Sympathetic::prepare(const int *params)
+{
+	for (int n = 0; n < ParameterCount; ++n)
+		prepared[n] = limitpar(n, params[n], prepared[ParameterType]);
+	preparestrings();
+}
+
+void Sympathetic::preparepreset(int npreset)
+{
+	const signed char *preset = getpreset(npreset);
+
+	for (int n = 0; n < ParameterCount; ++n)
+		prepared[n] = limitpar(n, preset[n], prepared[ParameterType]);
+	preparestrings();
+}
+
+void Sympathetic::preparestrings()
+{
+	float delays[CombFilterBank::max_strings];
+	int notes[max_strings];
+	int nr = calcDelays(prepared, samplerate, delays, notes);
+	filterBank.prepare(delays, nr * prepared[ParameterUnisonSize]);
+}
+
+void Sympathetic::noteOn(int note)
+{
+	assert(note >= 0 && note < 128);
+	notes_on[note / 32].fetch_or(1u << note % 32, std::memory_order_relaxed);
+}
+
+void Sympathetic::noteOff(int note)
+{
+	assert(note >= 0 && note < 128);
+	notes_on[note / 32].fetch_and(~(1u << note % 32), std::memory_order_relaxed);
+}
+
+void Sympathetic::allNotesOff()
+{
+	for (auto &notes : notes_on)
+		notes.store(0, std::memory_order_relaxed);
+}
+
+bool Sympathetic::isNoteOn(int note) const
+{
+	if (note < 0 || note >= 128) return false;
+	return notes_on[note / 32].load(std::memory_order_relaxed) & 1u << note % 32;
+}
+
+// A string is processed, when one of its harmonics is the fundamental of a note played,
+// or its fundamental is one of the harmonics of a note, or when the sustain pedal lifts
+// all dampers. It is retired, when it is not excited anymore and its resonance has
+// decayed to silence.
+void Sympathetic::activateStrings()
+{
+	static constexpr int harmonics[] = {0, 12, 19, 24, 28, 31, 34, 36}; // semitones
+
+	bool all = sustained.load(std::memory_order_relaxed);
+
+	for (int i = 0; i < strings_nr; ++i)
+	{
+		bool excited = all;
+		for (int h = 0; !excited && h < static_cast<int>(sizeof harmonics / sizeof *harmonics); ++h)
+			excited = isNoteOn(string_notes[i] - harmonics[h]) || isNoteOn(string_notes[i] + harmonics[h]);
+
+		for (int n = i * Punison_size; n < (i + 1) * Punison_size; ++n)
+			filterBank.active[n] = excited || filterBank.levels[n] > retire_silence;
+	}
 }
 
 } // namespace zyn
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <string>
 
 #include "AnalogFilter.h"
@@ -30,13 +31,28 @@ public:
 	void loadpreset(int npreset);
 	void changepar(int npar, int value, bool updateFreqs);
 	int getpar(int npar) const;
+	float getwet() const { return 2.0f * level * wet; } // gain of the wet signal
 	void cleanup();
 
 	void sustain(bool sustain);
 
+	// Only the strings related to the notes played, or still ringing, are processed.
+	// Called by core 0 for the notes of the TGs, which are mixed into the effect.
+	void noteOn(int note);
+	void noteOff(int note);
+	void allNotesOff();
+
+	// The delay lines of the strings are allocated by core 0 with the parameters,
+	// before they are applied. Called by core 0 only.
+	void prepare(int npar, int value);
+	void prepare(const int *params); // all parameters, in Parameter order
+	void preparepreset(int npreset);
+	void reclaim() { filterBank.reclaim(); }
+
 	std::atomic<bool> bypass;
 
 	static constexpr int presets_num = 8;
+	static constexpr int max_strings = CombFilterBank::max_strings / 3;
 
 	enum Parameter
 	{
@@ -91,7 +107,11 @@ private:
 	signed char Phighcut;
 	signed char Pnegate; // if the input is negated
 
-	float baseFreq;
+	int strings_nr;
+	int string_notes[max_strings]; // MIDI note of each string
+	std::atomic<uint32_t> notes_on[128 / 32];
+	std::atomic<bool> sustained;
+	signed char prepared[ParameterCount]; // the parameters for prepare(), core 0 only
 
 	void setmix(signed char _Pmix);
 	void setpanning(signed char _Ppanning);
@@ -99,10 +119,16 @@ private:
 	void setlevel(signed char _Plevel);
 	void setlowcut(signed char _Plowcut);
 	void sethighcut(signed char _Phighcut);
+	static const signed char *getpreset(int npreset);
+	static signed char limitpar(int npar, int value, int type);
 	void calcFreqs();
-	void calcFreqsGeneric();
-	void calcFreqsPiano();
-	void calcFreqsGuitar();
+	static int calcDelays(const signed char *par, float samplerate, float *delays, int *notes);
+	static int calcFreqsGeneric(const signed char *par, float samplerate, float *delays, int *notes);
+	static int calcFreqsPiano(const signed char *par, float samplerate, float *delays, int *notes);
+	static int calcFreqsGuitar(const signed char *par, float samplerate, float *delays, int *notes);
+	void preparestrings();
+	bool isNoteOn(int note) const;
+	void activateStrings();
 
 	// Real Parameters
 	AnalogFilter lpf, hpf;
@@ -13,6 +13,7 @@
 
 #include "WaveShapeSmps.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace zyn
@@ -310,4 +311,131 @@ void waveShapeSmps(int n, float *smps, signed char type, signed char drive, sign
 	}
 }
 
+WaveShaper::WaveShaper() :
+tables{},
+front{0},
+back{1},
+middle{2}
+{
+}
+
+void WaveShaper::prepare(float range, signed char type, signed char drive, signed char offset, signed char shape)
+{
+	Table &t = tables[back];
+	t.type = type;
+	t.drive = drive;
+	t.offset = offset;
+	t.shape = shape;
+	build(t, std::min(range, max_range));
+
+	back = middle.exchange(back | fresh, std::memory_order_acq_rel) & ~fresh;
+}
+
+void WaveShaper::process(int n, float *smps, signed char type, signed char drive, signed char offset, signed char shape)
+{
+#ifndef WAVESHAPER_EXACT
+	// take the table built last, if the parameters have changed
+	if (!tables[front].is(type, drive, offset, shape) && (middle.load(std::memory_order_relaxed) & fresh))
+		front = middle.exchange(front, std::memory_order_acq_rel) & ~fresh;
+
+	const Table &t = tables[front];
+
+	if (t.use && t.is(type, drive, offset, shape))
+	{
+		const float range = t.range;
+		const float scale = table_size / (2.0f * range);
+
+		bool in_range = true;
+		for (int i = 0; i < n; ++i)
+			in_range &= smps[i] > -range && smps[i] < range;
+
+		if (in_range)
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				// just below the range, pos may round up to table_size
+				float pos = (smps[i] + range) * scale;
+				int k = std::min(static_cast<int>(pos), table_size - 1);
+				float frac = pos - k;
+				smps[i] = t.smps[k] + frac * (t.smps[k + 1] - t.smps[k]);
+			}
+		}
+		else
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				float pos = (smps[i] + range) * scale;
+				if (pos >= 0.0f && pos < table_size)
+				{
+					int k = static_cast<int>(pos);
+					float frac = pos - k;
+					smps[i] = t.smps[k] + frac * (t.smps[k + 1] - t.smps[k]);
+				}
+				else
+					waveShapeSmps(1, smps + i, type, drive, offset, shape);
+			}
+		}
+
+		return;
+	}
+#endif
+
+	waveShapeSmps(n, smps, type, drive, offset, shape);
+}
+
+void WaveShaper::build(Table &t, float range)
+{
+	t.use = false;
+
+	switch (t.type)
+	{
+	case WaveShapeArctangent:
+	case WaveShapeAsymmetric:
+	case WaveShapeSine:
+	case WaveShapeZigzag:
+	case WaveShapeLimiter:
+	case WaveShapeInverseLimiter:
+	case WaveShapeSigmoid:
+	case WaveShapeTanhSoft:
+		break;
+	default:
+		return; // cheap enough, or not continuous
+	}
+
+	// a high drive bends the shape sharply, the range is halved until the
+	// interpolation error, which is largest between the points, is small enough
+	for (t.range = range; t.range >= range / 16; t.range *= 0.5f)
+	{
+		const float step = 2.0f * t.range / table_size;
+
+		for (int i = 0; i <= table_size; ++i)
+			t.smps[i] = i * step - t.range;
+		waveShapeSmps(table_size + 1, t.smps, t.type, t.drive, t.offset, t.shape);
+
+		static constexpr int part = 256;
+		float mid[part];
+		float peak = 0.0f;
+		float error = 0.0f;
+
+		for (int i = 0; i < table_size; i += part)
+		{
+			for (int k = 0; k < part; ++k)
+				mid[k] = (i + k + 0.5f) * step - t.range;
+			waveShapeSmps(part, mid, t.type, t.drive, t.offset, t.shape);
+
+			for (int k = 0; k < part; ++k)
+			{
+				peak = std::max(peak, fabsf(t.smps[i + k]));
+				error = std::max(error, fabsf(mid[k] - (t.smps[i + k] + t.smps[i + k + 1]) * 0.5f));
+			}
+		}
+
+		if (error <= tolerance * peak)
+		{
+			t.use = true;
+			return;
+		}
+	}
+}
+
 } // namespace zyn
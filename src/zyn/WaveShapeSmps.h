@@ -12,6 +12,8 @@
 */
 #pragma once
 
+#include <atomic>
+
 namespace zyn
 {
 
@@ -42,4 +44,49 @@ enum WaveShapeType
 // calculate the polyblamp residual value (called by waveshape function)
 float polyblampres(float smp, float ws, float dMax);
 
+// Waveshaper, which interpolates a table of the transfer function for the types
+// evaluating transcendental functions per sample. Core 0 builds the table for the
+// parameters before they are applied, process() takes it when they match. The table
+// covers the inputs the drive gives, shrunk until it follows the exact shape
+// closely, other inputs are shaped exactly. Define WAVESHAPER_EXACT to always
+// shape with waveShapeSmps, for validation.
+class WaveShaper
+{
+public:
+	WaveShaper();
+
+	// Builds the table for the parameters, which process() will get, for inputs
+	// up to range. Called by core 0 only.
+	void prepare(float range, signed char type, signed char drive, signed char offset, signed char shape);
+
+	void process(int n, float *smps, signed char type, signed char drive, signed char offset, signed char shape);
+
+private:
+	static constexpr int table_size = 4096;
+	static constexpr float max_range = 4.0f;
+	static constexpr float tolerance = 0.001f; // of the peak output
+	static constexpr int fresh = 4; // set with the middle table, until it is taken
+
+	struct Table
+	{
+		signed char type, drive, offset, shape;
+		bool use; // if the table is used for the parameters
+		float range; // larger inputs are shaped exactly
+		float smps[table_size + 1];
+
+		bool is(signed char type_, signed char drive_, signed char offset_, signed char shape_) const
+		{
+			return type == type_ && drive == drive_ && offset == offset_ && shape == shape_;
+		}
+	};
+
+	static void build(Table &t, float range);
+
+	// triple buffer of the tables
+	Table tables[3];
+	int front; // used by process()
+	int back; // built by prepare()
+	std::atomic<int> middle; // built last, or given back by process()
+};
+
 } // namespace zyn